@@ -93,6 +93,8 @@ namespace
         ParamIdMaskTex      = 2,
         ParamIdMaskAmount   = 3,
         ParamIdMixColor     = 4,
+        ParamIdAlpha        = 5,
+        ParamIdAlphaTexmap  = 6
     };
 
     enum MtlId
@@ -123,9 +125,12 @@ namespace
         TexmapMask7         = 6,
         TexmapMask8         = 7,
         TexmapMask9         = 8,
+        TexmapAlpha         = 9,
         TexmapCount         // keep last
     };
 
+    const int LayerCount = TexmapMask9 + 1;
+
     const MSTR g_texmap_slot_names[10] =
     {
         L"Mask 1",
@@ -137,6 +142,7 @@ namespace
         L"Mask 7",
         L"Mask 8",
         L"Mask 9",
+        L"Alpha"
     };
 
     const MSTR g_material_slot_names[11] =
@@ -178,21 +184,21 @@ namespace
             p_ui, TYPE_MTLBUTTON,       IDC_MTLBTN_BASE,
         p_end,
 
-        ParamIdLayerMtl, L"layer_material_list", TYPE_MTL_TAB, TexmapCount, P_SUBANIM | P_SHORT_LABELS, IDS_MATERIAL_LAYER,
+        ParamIdLayerMtl, L"layer_material_list", TYPE_MTL_TAB, LayerCount, P_SUBANIM | P_SHORT_LABELS, IDS_MATERIAL_LAYER,
             p_submtlno, 1,
             p_ui, TYPE_MTLBUTTON,       IDC_MTLBTN_LAYER_1, IDC_MTLBTN_LAYER_2, IDC_MTLBTN_LAYER_3,
                                         IDC_MTLBTN_LAYER_4, IDC_MTLBTN_LAYER_5, IDC_MTLBTN_LAYER_6,
                                         IDC_MTLBTN_LAYER_7, IDC_MTLBTN_LAYER_8, IDC_MTLBTN_LAYER_9,
         p_end,
 
-        ParamIdMaskTex, L"mask_list", TYPE_TEXMAP_TAB, TexmapCount, P_SUBANIM | P_SHORT_LABELS, IDS_MASK_TEXTURE,
+        ParamIdMaskTex, L"mask_list", TYPE_TEXMAP_TAB, LayerCount, P_SUBANIM | P_SHORT_LABELS, IDS_MASK_TEXTURE,
             p_subtexno, 0,
             p_ui, TYPE_TEXMAPBUTTON,    IDC_TEXBTN_MASK_1, IDC_TEXBTN_MASK_2, IDC_TEXBTN_MASK_3,
                                         IDC_TEXBTN_MASK_4, IDC_TEXBTN_MASK_5, IDC_TEXBTN_MASK_6,
                                         IDC_TEXBTN_MASK_7, IDC_TEXBTN_MASK_8, IDC_TEXBTN_MASK_9,
         p_end,
         
-        ParamIdMaskAmount, L"texture_amount_list", TYPE_FLOAT_TAB, TexmapCount, P_ANIMATABLE, IDS_MASK_AMOUNT,
+        ParamIdMaskAmount, L"texture_amount_list", TYPE_FLOAT_TAB, LayerCount, P_ANIMATABLE, IDS_MASK_AMOUNT,
             p_default, 100.0f,
             p_range, 0.0f, 100.0f,
             p_ui, TYPE_SPINNER, EDITTYPE_FLOAT,   
@@ -208,6 +214,16 @@ namespace
             0.1f,
         p_end,
 
+        ParamIdAlpha, L"alpha", TYPE_FLOAT, P_ANIMATABLE, IDS_ALPHA,
+            p_default, 100.0f,
+            p_range, 0.0f, 100.0f,
+            p_ui, TYPE_SLIDER, EDITTYPE_FLOAT, IDC_EDIT_ALPHA, IDC_SLIDER_ALPHA, 10.0f,
+        p_end,
+        ParamIdAlphaTexmap, L"alpha_texmap", TYPE_TEXMAP, P_NO_AUTO_LABELS, IDS_TEXMAP_ALPHA,
+            p_subtexno, TexmapAlpha,
+            p_ui, TYPE_TEXMAPBUTTON, IDC_TEXMAP_ALPHA,
+        p_end,
+
         // --- The end ---
         p_end);
 }
@@ -345,14 +361,26 @@ Texmap* AppleseedBlendMtl::GetSubTexmap(int i)
     Texmap* texmap;
     Interval valid;
 
-    m_pblock->GetValue(ParamIdMaskTex, 0, texmap, valid, i);
+    if (i == TexmapAlpha)
+        m_pblock->GetValue(ParamIdAlphaTexmap, 0, texmap, valid);
+    else m_pblock->GetValue(ParamIdMaskTex, 0, texmap, valid, i);
 
     return texmap;
 }
 
 void AppleseedBlendMtl::SetSubTexmap(int i, Texmap* texmap)
 {
-    m_pblock->SetValue(ParamIdMaskTex, 0, texmap, i);
+    if (i == TexmapAlpha)
+    {
+        m_pblock->SetValue(ParamIdAlphaTexmap, 0, texmap);
+
+        IParamMap2* map = m_pblock->GetMap();
+        if (map != nullptr)
+        {
+            map->SetText(ParamIdAlphaTexmap, texmap == nullptr ? L"" : L"M");
+        }
+    }
+    else m_pblock->SetValue(ParamIdMaskTex, 0, texmap, i);
 }
 
 int AppleseedBlendMtl::MapSlotType(int i)
@@ -417,6 +445,8 @@ Interval AppleseedBlendMtl::Validity(TimeValue t)
 ParamDlg* AppleseedBlendMtl::CreateParamDlg(HWND hwMtlEdit, IMtlParams* imp)
 {
     ParamDlg* param_dialog = g_appleseed_blendmtl_classdesc.CreateParamDlgs(hwMtlEdit, imp, this);
+    DbgAssert(m_pblock != nullptr);
+    update_map_buttons(m_pblock->GetMap());
     return param_dialog;
 }
 
@@ -623,6 +653,9 @@ asf::auto_release_ptr<asr::Material> AppleseedBlendMtl::create_osl_material(
                 tex,
                 mask_amount,
                 time);
+
+            shader_params.insert(
+                asf::format("MaskColor_{0}", layer_index).c_str(), fmt_osl_expr(fold_float_texture(tex, mask_amount, time)));
         }
 
         shader_params.insert(
@@ -633,7 +666,7 @@ asf::auto_release_ptr<asr::Material> AppleseedBlendMtl::create_osl_material(
     
     shader_group->add_shader("surface", "as_max_blend_material", name, shader_params);
     
-    std::string closure2surface_name = asf::format("{0}_closure2surface", name);
+    std::string closure2surface_name = LayerNames(name).get("closure2surface");
     shader_group.ref().add_shader("shader", "as_max_closure2surface", closure2surface_name.c_str(), asr::ParamArray());
 
     shader_group.ref().add_connection(
@@ -649,6 +682,7 @@ asf::auto_release_ptr<asr::Material> AppleseedBlendMtl::create_osl_material(
     //
 
     blend_material->get_parameters().insert("osl_surface", shader_group_name);
+    insert_alpha_map(assembly, blend_material->get_parameters(), false, time);
 
     return blend_material;
 }
@@ -658,7 +692,30 @@ asf::auto_release_ptr<asr::Material> AppleseedBlendMtl::create_builtin_material(
     const char*         name,
     const TimeValue     time)
 {
-    return asr::GenericMaterialFactory().create(name, asr::ParamArray());
+    asr::ParamArray material_params;
+    insert_alpha_map(assembly, material_params, true, time);
+
+    return asr::GenericMaterialFactory().create(name, material_params);
+}
+
+void AppleseedBlendMtl::insert_alpha_map(
+    asr::Assembly&      assembly,
+    asr::ParamArray&    material_params,
+    const bool          use_max_procedural_maps,
+    const TimeValue     time)
+{
+    Texmap* alpha_texmap = nullptr;
+    m_pblock->GetValue(ParamIdAlphaTexmap, time, alpha_texmap, FOREVER);
+
+    const std::string instance_name =
+        insert_cutout_texture_and_instance(
+            assembly,
+            alpha_texmap,
+            use_max_procedural_maps,
+            time);
+    if (!instance_name.empty())
+        material_params.insert("alpha_map", instance_name);
+    else material_params.insert("alpha_map", m_pblock->GetFloat(ParamIdAlpha, time, FOREVER) / 100.0f);
 }
 
 
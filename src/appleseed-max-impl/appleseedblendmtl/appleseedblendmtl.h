@@ -49,6 +49,7 @@
 
 // Forward declarations.
 namespace renderer  { class Material; }
+namespace renderer  { class ParamArray; }
 class BaseInterface;
 class Bitmap;
 class Color;
@@ -155,6 +156,12 @@ class AppleseedBlendMtl
         renderer::Assembly& assembly,
         const char*         name,
         const TimeValue     time);
+
+    void insert_alpha_map(
+        renderer::Assembly&     assembly,
+        renderer::ParamArray&   material_params,
+        const bool              use_max_procedural_maps,
+        const TimeValue         time);
 };
 
 
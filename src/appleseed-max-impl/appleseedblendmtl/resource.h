@@ -58,6 +58,12 @@
 #define IDS_MATERIAL_BASE               9102
 #define IDS_MATERIAL_LAYER              9103
 #define IDS_MASK_TEXTURE                9104
+#define IDC_LABEL_ALPHA                 9110
+#define IDC_EDIT_ALPHA                  9111
+#define IDC_SLIDER_ALPHA                9112
+#define IDC_TEXMAP_ALPHA                9113
+#define IDS_ALPHA                       9114
+#define IDS_TEXMAP_ALPHA                9115
 
 // Next default values for new objects
 // 
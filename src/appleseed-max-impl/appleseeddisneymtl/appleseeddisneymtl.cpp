@@ -768,18 +768,18 @@ asf::auto_release_ptr<asr::Material> AppleseedDisneyMtl::create_osl_material(
 
     shader_group->add_shader("surface", "as_max_disney_material", name, 
         asr::ParamArray()
-            .insert("BaseColor", fmt_osl_expr(to_color3f(m_base_color)))
-            .insert("Metallic", fmt_osl_expr(m_metallic / 100.0f))
-            .insert("Specular", fmt_osl_expr(m_specular / 100.0f))
-            .insert("SpecularTint", fmt_osl_expr(m_specular_tint / 100.0f))
-            .insert("Roughness", fmt_osl_expr(m_roughness / 100.0f))
-            .insert("Sheen", fmt_osl_expr(m_sheen / 100.0f))
-            .insert("SheenTint", fmt_osl_expr(m_sheen_tint / 100.0f))
-            .insert("Anisotropic", fmt_osl_expr(m_anisotropy))
-            .insert("Clearcoat", fmt_osl_expr(m_clearcoat / 100.0f))
-            .insert("ClearcoatGloss", fmt_osl_expr(m_clearcoat_gloss / 100.0f)));
-
-    std::string closure2surface_name = asf::format("{0}_closure2surface", name);
+            .insert("BaseColor", fmt_osl_expr(fold_color_texture(m_base_color_texmap, m_base_color, time)))
+            .insert("Metallic", fmt_osl_expr(fold_float_texture(m_metallic_texmap, m_metallic / 100.0f, time)))
+            .insert("Specular", fmt_osl_expr(fold_float_texture(m_specular_texmap, m_specular / 100.0f, time)))
+            .insert("SpecularTint", fmt_osl_expr(fold_float_texture(m_specular_tint_texmap, m_specular_tint / 100.0f, time)))
+            .insert("Roughness", fmt_osl_expr(fold_float_texture(m_roughness_texmap, m_roughness / 100.0f, time)))
+            .insert("Sheen", fmt_osl_expr(fold_float_texture(m_sheen_texmap, m_sheen / 100.0f, time)))
+            .insert("SheenTint", fmt_osl_expr(fold_float_texture(m_sheen_tint_texmap, m_sheen_tint / 100.0f, time)))
+            .insert("Anisotropic", fmt_osl_expr(fold_float_texture(m_anisotropy_texmap, m_anisotropy, time)))
+            .insert("Clearcoat", fmt_osl_expr(fold_float_texture(m_clearcoat_texmap, m_clearcoat / 100.0f, time)))
+            .insert("ClearcoatGloss", fmt_osl_expr(fold_float_texture(m_clearcoat_gloss_texmap, m_clearcoat_gloss / 100.0f, time))));
+
+    std::string closure2surface_name = LayerNames(name).get("closure2surface");
     shader_group.ref().add_shader("shader", "as_max_closure2surface", closure2surface_name.c_str(), asr::ParamArray());
 
     shader_group.ref().add_connection(
@@ -798,14 +798,11 @@ asf::auto_release_ptr<asr::Material> AppleseedDisneyMtl::create_osl_material(
     material_params.insert("osl_surface", shader_group_name);
 
     const std::string instance_name =
-        insert_texture_and_instance(
+        insert_cutout_texture_and_instance(
             assembly,
             m_alpha_texmap,
             false,
-            time,
-            asr::ParamArray(),
-            asr::ParamArray()
-                .insert("alpha_mode", "detect"));
+            time);
     if (!instance_name.empty())
         material_params.insert("alpha_map", instance_name);
     else material_params.insert("alpha_map", m_alpha / 100.0f);
@@ -906,14 +903,11 @@ asf::auto_release_ptr<asr::Material> AppleseedDisneyMtl::create_builtin_material
     //
 
     // Alpha map.
-    instance_name = insert_texture_and_instance(
+    instance_name = insert_cutout_texture_and_instance(
         assembly,
         m_alpha_texmap,
         use_max_procedural_maps,
-        time,
-        asr::ParamArray(),
-        asr::ParamArray()
-            .insert("alpha_mode", "detect"));
+        time);
     if (!instance_name.empty())
         material_params.insert("alpha_map", instance_name);
     else material_params.insert("alpha_map", m_alpha / 100.0f);
@@ -111,7 +111,9 @@ namespace
         ParamIdBumpMethod           = 14,
         ParamIdBumpTexmap           = 15,
         ParamIdBumpAmount           = 16,
-        ParamIdBumpUpVector         = 17
+        ParamIdBumpUpVector         = 17,
+        ParamIdAlpha                = 18,
+        ParamIdAlphaTexmap          = 19
     };
 
     enum TexmapId
@@ -124,6 +126,7 @@ namespace
         TexmapIdAnisotropy          = 4,
         TexmapIdVolumeColor         = 5,
         TexmapIdBumpMap             = 6,
+        TexmapIdAlpha               = 7,
         TexmapCount                 // keep last
     };
 
@@ -135,7 +138,8 @@ namespace
         L"Roughness",
         L"Anisotropy",
         L"Volume Color",
-        L"Bump Map"
+        L"Bump Map",
+        L"Alpha"
     };
 
     const ParamId g_texmap_id_to_param_id[TexmapCount] =
@@ -146,7 +150,8 @@ namespace
         ParamIdRoughnessTexmap,
         ParamIdAnisotropyTexmap,
         ParamIdVolumeColorTexmap,
-        ParamIdBumpTexmap
+        ParamIdBumpTexmap,
+        ParamIdAlphaTexmap
     };
 
     ParamBlockDesc2 g_block_desc(
@@ -249,6 +254,16 @@ namespace
             p_ui, ParamMapIdGlass, TYPE_SPINNER, EDITTYPE_FLOAT, IDC_EDIT_SCALE, IDC_SPINNER_SCALE, SPIN_AUTOSCALE,
         p_end,
 
+        ParamIdAlpha, L"alpha", TYPE_FLOAT, P_ANIMATABLE, IDS_ALPHA,
+            p_default, 100.0f,
+            p_range, 0.0f, 100.0f,
+            p_ui, ParamMapIdGlass, TYPE_SLIDER, EDITTYPE_FLOAT, IDC_EDIT_ALPHA, IDC_SLIDER_ALPHA, 10.0f,
+        p_end,
+        ParamIdAlphaTexmap, L"alpha_texmap", TYPE_TEXMAP, P_NO_AUTO_LABELS, IDS_TEXMAP_ALPHA,
+            p_subtexno, TexmapIdAlpha,
+            p_ui, ParamMapIdGlass, TYPE_TEXMAPBUTTON, IDC_TEXMAP_ALPHA,
+        p_end,
+
         // --- Parameters specifications for Bump rollup ---
 
         ParamIdBumpMethod, L"bump_method", TYPE_INT, 0, IDS_BUMP_METHOD,
@@ -301,6 +316,8 @@ AppleseedGlassMtl::AppleseedGlassMtl()
   , m_volume_color(1.0f, 1.0f, 1.0f)
   , m_volume_color_texmap(nullptr)
   , m_scale(0.0f)
+  , m_alpha(100.0f)
+  , m_alpha_texmap(nullptr)
   , m_bump_method(0)
   , m_bump_texmap(nullptr)
   , m_bump_amount(1.0f)
@@ -490,6 +507,9 @@ void AppleseedGlassMtl::Update(TimeValue t, Interval& valid)
 
         m_pblock->GetValue(ParamIdScale, t, m_scale, m_params_validity);
 
+        m_pblock->GetValue(ParamIdAlpha, t, m_alpha, m_params_validity);
+        m_pblock->GetValue(ParamIdAlphaTexmap, t, m_alpha_texmap, m_params_validity);
+
         m_pblock->GetValue(ParamIdBumpMethod, t, m_bump_method, m_params_validity);
         m_pblock->GetValue(ParamIdBumpTexmap, t, m_bump_texmap, m_params_validity);
         m_pblock->GetValue(ParamIdBumpAmount, t, m_bump_amount, m_params_validity);
@@ -685,17 +705,17 @@ asf::auto_release_ptr<asr::Material> AppleseedGlassMtl::create_osl_material(
 
     shader_group->add_shader("surface", "as_max_glass_material", name, 
         asr::ParamArray()
-            .insert("SurfaceTransmittance", fmt_osl_expr(to_color3f(m_surface_color)))
-            .insert("ReflectionTint", fmt_osl_expr(to_color3f(m_reflection_tint)))
-            .insert("RefractionTint", fmt_osl_expr(to_color3f(m_refraction_tint)))
-            .insert("VolumeTransmittance", fmt_osl_expr(to_color3f(m_volume_color)))
-            .insert("Roughness", fmt_osl_expr(m_roughness / 100.0f))
-            .insert("Anisotropic", fmt_osl_expr(m_anisotropy / 100.0f))
+            .insert("SurfaceTransmittance", fmt_osl_expr(fold_color_texture(m_surface_color_texmap, m_surface_color, time)))
+            .insert("ReflectionTint", fmt_osl_expr(fold_color_texture(m_reflection_tint_texmap, m_reflection_tint, time)))
+            .insert("RefractionTint", fmt_osl_expr(fold_color_texture(m_refraction_tint_texmap, m_refraction_tint, time)))
+            .insert("VolumeTransmittance", fmt_osl_expr(fold_color_texture(m_volume_color_texmap, m_volume_color, time)))
+            .insert("Roughness", fmt_osl_expr(fold_float_texture(m_roughness_texmap, m_roughness / 100.0f, time)))
+            .insert("Anisotropic", fmt_osl_expr(fold_float_texture(m_anisotropy_texmap, m_anisotropy / 100.0f, time)))
             .insert("Ior", fmt_osl_expr(m_ior))
             .insert("VolumeTransmittanceDistance", fmt_osl_expr(m_scale))
             .insert("Distribution", fmt_osl_expr("ggx")));
 
-    std::string closure2surface_name = asf::format("{0}_closure2surface", name);
+    std::string closure2surface_name = LayerNames(name).get("closure2surface");
     shader_group.ref().add_shader("shader", "as_max_closure2surface", closure2surface_name.c_str(), asr::ParamArray());
 
     shader_group.ref().add_connection(
@@ -713,6 +733,16 @@ asf::auto_release_ptr<asr::Material> AppleseedGlassMtl::create_osl_material(
     asr::ParamArray material_params;
     material_params.insert("osl_surface", shader_group_name);
 
+    const std::string instance_name =
+        insert_cutout_texture_and_instance(
+            assembly,
+            m_alpha_texmap,
+            false,
+            time);
+    if (!instance_name.empty())
+        material_params.insert("alpha_map", instance_name);
+    else material_params.insert("alpha_map", m_alpha / 100.0f);
+
     return asr::OSLMaterialFactory().create(name, material_params);
 }
 
@@ -809,6 +839,16 @@ asf::auto_release_ptr<asr::Material> AppleseedGlassMtl::create_builtin_material(
     // Material.
     //
 
+    // Alpha map.
+    instance_name = insert_cutout_texture_and_instance(
+        assembly,
+        m_alpha_texmap,
+        use_max_procedural_maps,
+        time);
+    if (!instance_name.empty())
+        material_params.insert("alpha_map", instance_name);
+    else material_params.insert("alpha_map", m_alpha / 100.0f);
+
     // Displacement.
     instance_name = insert_texture_and_instance(
         assembly,
@@ -161,6 +161,8 @@ class AppleseedGlassMtl
     Color           m_volume_color;
     Texmap*         m_volume_color_texmap;
     float           m_scale;
+    float           m_alpha;
+    Texmap*         m_alpha_texmap;
     int             m_bump_method;
     Texmap*         m_bump_texmap;
     float           m_bump_amount;
@@ -53,6 +53,13 @@
 #define IDC_SPINNER_SCALE                   2082
 #define IDS_SCALE                           2083
 
+#define IDC_LABEL_ALPHA                     2090
+#define IDC_EDIT_ALPHA                      2091
+#define IDC_SLIDER_ALPHA                    2092
+#define IDC_TEXMAP_ALPHA                    2093
+#define IDS_ALPHA                           2094
+#define IDS_TEXMAP_ALPHA                    2095
+
 // Next default values for new objects
 // 
 #ifdef APSTUDIO_INVOKED
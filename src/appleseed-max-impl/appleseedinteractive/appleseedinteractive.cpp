@@ -36,6 +36,10 @@
 #include "appleseedrenderer/projectbuilder.h"
 #include "utilities.h"
 
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+#include "renderer/api/scene.h"
+
 // Boost headers.
 #include "boost/thread/locks.hpp"
 #include "boost/thread/mutex.hpp"
@@ -46,6 +50,10 @@
 
 // Standard headers.
 #include <clocale>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
 
 namespace asf = foundation;
 namespace asr = renderer;
@@ -226,6 +234,85 @@ namespace
         INode*                              m_active_camera;
     };
 
+    class GeometryChangeCallback
+      : public INodeEventCallback
+    {
+      public:
+        explicit GeometryChangeCallback(AppleseedInteractiveRender* renderer)
+          : m_renderer(renderer)
+          , m_max_hwnd(GetCOREInterface()->GetMAXHWnd())
+        {
+            m_callback_key = GetISceneEventManager()->RegisterCallback(this, false, 100, true);
+        }
+
+        ~GeometryChangeCallback() override
+        {
+            GetISceneEventManager()->UnRegisterCallback(m_callback_key);
+            KillTimer(m_max_hwnd, TimerId);
+        }
+
+        static VOID CALLBACK timer_proc(
+            _In_ HWND     hwnd,
+            _In_ UINT     msg,
+            _In_ UINT_PTR id,
+            _In_ DWORD    time
+        )
+        {
+            KillTimer(hwnd, id);
+            {
+                boost::mutex::scoped_lock lock(g_current_interactive_mutex);
+                if (g_current_interactive != nullptr && g_current_interactive->update_geometry())
+                    g_current_interactive->get_render_session()->reininitialize_render();
+            }
+        }
+
+        void GeometryChanged(NodeKeyTab& nodes) override
+        {
+            schedule_update(nodes);
+        }
+
+        void TopologyChanged(NodeKeyTab& nodes) override
+        {
+            schedule_update(nodes);
+        }
+
+      private:
+        // Modifier slider drags send a stream of events: only rebuild once they settle down.
+        static const UINT_PTR TimerId = 1;     // must differ from the viewport callback timer
+        static const UINT TimerDelay = 250;     // milliseconds
+
+        SceneEventNamespace::CallbackKey    m_callback_key;
+        AppleseedInteractiveRender*         m_renderer;
+        HWND                                m_max_hwnd;
+
+        void schedule_update(NodeKeyTab& nodes)
+        {
+            for (int i = 0, e = nodes.Count(); i < e; ++i)
+                m_renderer->mark_geometry_dirty(nodes[i]);
+
+            SetTimer(m_max_hwnd, TimerId, TimerDelay, timer_proc);
+        }
+    };
+
+    // Settings spinner drags send a stream of changes: only apply them once they settle down.
+    const UINT_PTR SettingsTimerId = 2;     // must differ from the viewport and geometry callback timers
+    const UINT SettingsTimerDelay = 250;    // milliseconds
+
+    VOID CALLBACK settings_timer_proc(
+        _In_ HWND     hwnd,
+        _In_ UINT     msg,
+        _In_ UINT_PTR id,
+        _In_ DWORD    time
+    )
+    {
+        KillTimer(hwnd, id);
+        {
+            boost::mutex::scoped_lock lock(g_current_interactive_mutex);
+            if (g_current_interactive != nullptr && g_current_interactive->update_settings())
+                g_current_interactive->get_render_session()->reininitialize_render();
+        }
+    }
+
     class ViewportCallback 
       : public RedrawViewsCallback
     {
@@ -369,13 +456,84 @@ asf::auto_release_ptr<asr::Project> AppleseedInteractiveRender::prepare_project(
             renderer_settings,
             m_bitmap,
             time,
-            m_progress_cb));
+            m_progress_cb,
+            &m_exported_nodes));
 
     std::setlocale(LC_ALL, previous_locale.c_str());
 
     return project;
 }
 
+void AppleseedInteractiveRender::mark_geometry_dirty(const NodeEventNamespace::NodeKey node_key)
+{
+    m_dirty_nodes.insert(node_key);
+}
+
+bool AppleseedInteractiveRender::update_geometry()
+{
+    std::string previous_locale(std::setlocale(LC_ALL, "C"));
+
+    // Nodes sharing the same 3ds Max object share their appleseed objects: only rebuild them once.
+    std::set<std::string> rebuilt_objects;
+    bool updated = false;
+
+    for (const auto node_key : m_dirty_nodes)
+    {
+        // Skip nodes that were deleted or that are not part of the exported scene.
+        INode* node = NodeEventNamespace::GetNodeByKey(node_key);
+        if (node == nullptr)
+            continue;
+
+        const auto it = m_exported_nodes.find(node);
+        if (it == m_exported_nodes.end() || it->second.m_object_names.empty())
+            continue;
+
+        const ExportedNodeInfo& node_info = it->second;
+        if (!rebuilt_objects.insert(node_info.m_assembly_name + "/" + node_info.m_object_names.front()).second)
+            continue;
+
+        std::unique_ptr<asr::ObjectContainer> objects(new asr::ObjectContainer());
+        if (!rebuild_mesh_objects(*objects, node_info, m_time))
+        {
+            RENDERER_LOG_WARNING(
+                "the number of meshes of object \"%s\" has changed, restart the interactive session to update it.",
+                wide_to_utf8(node->GetName()).c_str());
+            continue;
+        }
+
+        get_render_session()->schedule_object_update(node_info.m_assembly_name, std::move(objects));
+        updated = true;
+    }
+
+    m_dirty_nodes.clear();
+
+    std::setlocale(LC_ALL, previous_locale.c_str());
+
+    return updated;
+}
+
+void AppleseedInteractiveRender::mark_settings_dirty(const RendererSettings& settings)
+{
+    if (m_render_session == nullptr)
+        return;
+
+    m_dirty_settings.reset(new RendererSettings(settings));
+    m_dirty_settings->m_output_mode = RendererSettings::OutputMode::RenderOnly;
+
+    SetTimer(GetCOREInterface()->GetMAXHWnd(), SettingsTimerId, SettingsTimerDelay, settings_timer_proc);
+}
+
+bool AppleseedInteractiveRender::update_settings()
+{
+    if (m_dirty_settings == nullptr)
+        return false;
+
+    const bool updated = get_render_session()->schedule_settings_update(*m_dirty_settings);
+    m_dirty_settings.reset();
+
+    return updated;
+}
+
 void AppleseedInteractiveRender::update_camera_object(INode* camera)
 {
     ViewParams view_params;
@@ -453,6 +611,7 @@ void AppleseedInteractiveRender::BeginSession()
 
     if (active_cam != nullptr)
         m_node_callback.reset(new SceneChangeCallback(this, active_cam));
+    m_geometry_callback.reset(new GeometryChangeCallback(this));
     m_view_callback.reset(new ViewportCallback());
 
     m_render_session->start_render();
@@ -463,7 +622,9 @@ void AppleseedInteractiveRender::EndSession()
     if (m_render_session != nullptr)
     {
         m_node_callback.reset(nullptr);
+        m_geometry_callback.reset(nullptr);
         m_view_callback.reset(nullptr);
+        KillTimer(GetCOREInterface()->GetMAXHWnd(), SettingsTimerId);
         m_render_session->abort_render();
         
         {
@@ -486,6 +647,10 @@ void AppleseedInteractiveRender::EndSession()
     
     render_end(m_entities.m_objects, m_time);
 
+    m_exported_nodes.clear();
+    m_dirty_nodes.clear();
+    m_dirty_settings.reset();
+
     if (m_progress_cb)
         m_progress_cb->SetTitle(L"Done.");
 }
@@ -30,6 +30,8 @@
 
 // appleseed-max headers.
 #include "appleseedrenderer/maxsceneentities.h"
+#include "appleseedrenderer/projectbuilder.h"
+#include "appleseedrenderer/renderersettings.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/windows.h"    // include before 3ds Max headers
@@ -45,12 +47,12 @@
 
 // Standard headers.
 #include <memory>
+#include <set>
 #include <vector>
 
 // Forward declarations.
 namespace renderer { class Project; }
 class InteractiveSession;
-class RendererSettings;
 class ViewParams;
 
 class AppleseedInteractiveRender
@@ -98,11 +100,28 @@ class AppleseedInteractiveRender
 
     void update_camera_object(INode* camera);
     void update_render_view();
+
+    // Remember that the geometry of a node has changed.
+    void mark_geometry_dirty(const NodeEventNamespace::NodeKey node_key);
+
+    // Rebuild the objects of all nodes marked dirty and schedule their replacement.
+    // Return true if at least one object update was scheduled.
+    bool update_geometry();
+
+    // Remember new renderer settings and apply them to the running session once
+    // the user stops editing them.
+    void mark_settings_dirty(const RendererSettings& settings);
+
+    // Apply the last settings passed to mark_settings_dirty() to the running session.
+    // Return true if at least one configuration parameter was updated.
+    bool update_settings();
+
     InteractiveSession* get_render_session();
 
   private:
     std::unique_ptr<InteractiveSession>             m_render_session;
     std::unique_ptr<INodeEventCallback>             m_node_callback;
+    std::unique_ptr<INodeEventCallback>             m_geometry_callback;
     std::unique_ptr<RedrawViewsCallback>            m_view_callback;
     foundation::auto_release_ptr<renderer::Project> m_project;
     Bitmap*                                         m_bitmap;
@@ -111,6 +130,9 @@ class AppleseedInteractiveRender
     HWND                                            m_owner_wnd;
     IRenderProgressCallback*                        m_progress_cb;
     MaxSceneEntities                                m_entities;
+    ExportedNodeMap                                 m_exported_nodes;
+    std::set<NodeEventNamespace::NodeKey>           m_dirty_nodes;
+    std::unique_ptr<RendererSettings>               m_dirty_settings;
     TimeValue                                       m_time;
     Box2                                            m_region;
     INode*                                          m_scene_inode;
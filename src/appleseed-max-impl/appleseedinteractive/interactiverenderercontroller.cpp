@@ -29,26 +29,144 @@
 // Interface header.
 #include "interactiverenderercontroller.h"
 
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/string.h"
+
 // 3ds Max headers.
 #include <interactiverender.h>
 
 // Standard headers.
+#include <algorithm>
 #include <utility>
+#include <vector>
 
+namespace asf = foundation;
 namespace asr = renderer;
 
+namespace
+{
+    asr::Assembly* find_assembly(
+        asr::AssemblyContainer& assemblies,
+        const char*             name)
+    {
+        asr::Assembly* assembly = assemblies.get_by_name(name);
+        if (assembly != nullptr)
+            return assembly;
+
+        for (auto& parent : assemblies)
+        {
+            assembly = find_assembly(parent.assemblies(), name);
+            if (assembly != nullptr)
+                return assembly;
+        }
+
+        return nullptr;
+    }
+
+    void apply_config_changes(
+        const RendererSettings::ConfigChanges&  changes,
+        asr::ParamArray&                        params)
+    {
+        for (const auto& change : changes)
+        {
+            if (change.m_removed)
+                params.remove_path(change.m_path.c_str());
+            else params.insert_path(change.m_path.c_str(), change.m_value);
+        }
+    }
+
+    template <typename Duration>
+    double to_milliseconds(const Duration& duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+
+//
+// ObjectUpdateAction class implementation.
+//
+
+void ObjectUpdateAction::update()
+{
+    asr::Assembly* assembly =
+        find_assembly(m_project.get_scene()->assemblies(), m_assembly_name.c_str());
+    if (assembly == nullptr)
+        return;
+
+    std::vector<asr::Object*> objects;
+    for (auto& object : *m_objects)
+        objects.push_back(&object);
+
+    // Replace the old objects by the new ones. Names are preserved so object instances remain valid.
+    for (auto object : objects)
+    {
+        asr::Object* old_object = assembly->objects().get_by_name(object->get_name());
+        if (old_object != nullptr)
+            assembly->objects().remove(old_object);
+
+        assembly->objects().insert(m_objects->remove(object));
+    }
+
+    // Force the acceleration structures of the assembly to be rebuilt.
+    assembly->bump_version_id();
+}
+
+
+//
+// ConfigUpdateAction class implementation.
+//
+
+void ConfigUpdateAction::update()
+{
+    // The master renderer works on its own copy of the configuration: update both so that
+    // the next frame uses the new values and the project stays consistent with the session.
+    apply_config_changes(m_changes, m_project_params);
+    apply_config_changes(m_changes, m_renderer_params);
+}
+
+
+//
+// InteractiveRendererController class implementation.
+//
+
 InteractiveRendererController::InteractiveRendererController()
   : m_status(ContinueRendering)
+  , m_restart_pending(false)
+  , m_restart_count(0)
+  , m_total_restart_latency(0.0)
+  , m_max_restart_latency(0.0)
 {
 }
 
 void InteractiveRendererController::on_rendering_begin()
 {
-    for (auto& updater : m_scheduled_actions)
-        updater->update();
-    
-    m_scheduled_actions.clear();
-    m_status = ContinueRendering;
+    {
+        std::lock_guard<std::mutex> lock(m_restart_mutex);
+        if (m_restart_pending)
+            m_restart_begin_time = Clock::now();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_scheduled_actions_mutex);
+
+        for (auto& updater : m_scheduled_actions)
+            updater->update();
+
+        m_scheduled_actions.clear();
+    }
+
+    // Only clear the restart request that led here: an abort or pause requested
+    // concurrently must survive the start of the next pass.
+    Status expected = m_status;
+    do
+    {
+        if (expected != RestartRendering && expected != ReinitializeRendering)
+            return;
+    } while (!m_status.compare_exchange_weak(expected, ContinueRendering));
 }
 
 asr::IRendererController::Status InteractiveRendererController::get_status() const
@@ -58,10 +176,73 @@ asr::IRendererController::Status InteractiveRendererController::get_status() con
 
 void InteractiveRendererController::set_status(const Status status)
 {
-    m_status = status;
+    if (status != ReinitializeRendering)
+    {
+        m_status = status;
+        return;
+    }
+
+    // Hold the lock while swapping the status so that on_frame_update() sees the pending restart.
+    std::lock_guard<std::mutex> lock(m_restart_mutex);
+
+    // Never turn an abort into a restart, even if the abort is requested concurrently.
+    Status expected = m_status;
+    do
+    {
+        if (expected == AbortRendering)
+            return;
+    } while (!m_status.compare_exchange_weak(expected, status));
+
+    // Measure latency from the first of a burst of restart requests.
+    if (!m_restart_pending)
+    {
+        m_restart_request_time = Clock::now();
+        m_restart_pending = true;
+    }
 }
 
 void InteractiveRendererController::schedule_update(std::unique_ptr<ScheduledAction> updater)
 {
+    std::lock_guard<std::mutex> lock(m_scheduled_actions_mutex);
     m_scheduled_actions.push_back(std::move(updater));
 }
+
+void InteractiveRendererController::on_frame_update()
+{
+    if (m_status != ContinueRendering)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_restart_mutex);
+
+    if (!m_restart_pending)
+        return;
+
+    m_restart_pending = false;
+
+    const auto now = Clock::now();
+    const double cancel_latency = to_milliseconds(m_restart_begin_time - m_restart_request_time);
+    const double restart_latency = to_milliseconds(now - m_restart_request_time);
+
+    ++m_restart_count;
+    m_total_restart_latency += restart_latency;
+    m_max_restart_latency = std::max(m_max_restart_latency, restart_latency);
+
+    RENDERER_LOG_DEBUG(
+        "interactive restart: %.1f ms to stop the previous frame, %.1f ms to first pixels.",
+        cancel_latency,
+        restart_latency);
+}
+
+void InteractiveRendererController::print_restart_statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_restart_mutex);
+
+    if (m_restart_count == 0)
+        return;
+
+    RENDERER_LOG_INFO(
+        "interactive restarts: %s, average latency %.1f ms, worst latency %.1f ms.",
+        asf::pretty_uint(m_restart_count).c_str(),
+        m_total_restart_latency / m_restart_count,
+        m_max_restart_latency);
+}
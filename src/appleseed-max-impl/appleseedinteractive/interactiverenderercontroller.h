@@ -38,9 +38,15 @@
 
 // appleseed-max headers.
 #include "appleseedinteractive/appleseedinteractive.h"
+#include "appleseedrenderer/renderersettings.h"
 
 // Standard headers.
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 // Forward declarations.
@@ -77,6 +83,50 @@ class CameraObjectUpdateAction
     renderer::Project&                                m_project;
 };
 
+class ObjectUpdateAction
+  : public ScheduledAction
+{
+  public:
+    ObjectUpdateAction(
+        renderer::Project&                              project,
+        const std::string&                              assembly_name,
+        std::unique_ptr<renderer::ObjectContainer>      objects)
+      : m_project(project)
+      , m_assembly_name(assembly_name)
+      , m_objects(std::move(objects))
+    {
+    }
+
+    void update() override;
+
+  public:
+    std::unique_ptr<renderer::ObjectContainer>        m_objects;
+    std::string                                       m_assembly_name;
+    renderer::Project&                                m_project;
+};
+
+class ConfigUpdateAction
+  : public ScheduledAction
+{
+  public:
+    ConfigUpdateAction(
+        renderer::ParamArray&                           project_params,
+        renderer::ParamArray&                           renderer_params,
+        const RendererSettings::ConfigChanges&          changes)
+      : m_project_params(project_params)
+      , m_renderer_params(renderer_params)
+      , m_changes(changes)
+    {
+    }
+
+    void update() override;
+
+  public:
+    renderer::ParamArray&                             m_project_params;
+    renderer::ParamArray&                             m_renderer_params;
+    RendererSettings::ConfigChanges                   m_changes;
+};
+
 class InteractiveRendererController
   : public renderer::DefaultRendererController
 {
@@ -90,7 +140,24 @@ class InteractiveRendererController
 
     void schedule_update(std::unique_ptr<ScheduledAction> updater);
 
+    // Called by the tile callback when a new frame has been delivered to the display.
+    void on_frame_update();
+
+    void print_restart_statistics() const;
+
   private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::mutex                                      m_scheduled_actions_mutex;
     std::vector<std::unique_ptr<ScheduledAction>>   m_scheduled_actions;
-    Status                                          m_status;
+    std::atomic<Status>                             m_status;
+
+    // Restart latency tracking.
+    mutable std::mutex                              m_restart_mutex;
+    bool                                            m_restart_pending;
+    Clock::time_point                               m_restart_request_time;
+    Clock::time_point                               m_restart_begin_time;
+    size_t                                          m_restart_count;
+    double                                          m_total_restart_latency;    // in milliseconds
+    double                                          m_max_restart_latency;      // in milliseconds
 };
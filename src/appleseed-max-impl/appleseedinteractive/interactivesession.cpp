@@ -33,9 +33,16 @@
 #include "appleseedinteractive/interactivetilecallback.h"
 
 // appleseed.renderer headers.
+#include "renderer/api/log.h"
 #include "renderer/api/project.h"
 #include "renderer/api/rendering.h"
 
+// appleseed.foundation headers.
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <utility>
+
 namespace asf = foundation;
 namespace asr = renderer;
 
@@ -48,28 +55,30 @@ InteractiveSession::InteractiveSession(
   , m_iirender_mgr(iirender_mgr)
   , m_renderer_settings(settings)
   , m_bitmap(bitmap)
-  , m_render_ctrl(nullptr)
+  , m_render_ctrl(new InteractiveRendererController())
 {
-}
-
-void InteractiveSession::render_thread()
-{
-    // Create the renderer controller.
-    m_render_ctrl.reset(new InteractiveRendererController());
-
-    // Create the tile callback.
-    InteractiveTileCallback m_tile_callback(m_bitmap, m_iirender_mgr, m_render_ctrl.get());
+    // The renderer controller is created upfront so that restart and abort requests
+    // issued before the render thread has started are not lost.
 
-    // Create the master renderer.
-    std::auto_ptr<asr::MasterRenderer> renderer(
+    // The master renderer is created upfront as well so that settings updates can
+    // reach its parameters at any time.
+    m_tile_callback.reset(new InteractiveTileCallback(m_bitmap, m_iirender_mgr, m_render_ctrl.get()));
+    m_renderer.reset(
         new asr::MasterRenderer(
             *m_project,
             m_project->configurations().get_by_name("interactive")->get_inherited_parameters(),
             m_render_ctrl.get(),
-            &m_tile_callback));
+            m_tile_callback.get()));
+}
+
+InteractiveSession::~InteractiveSession()
+{
+}
 
+void InteractiveSession::render_thread()
+{
     // Render the frame.
-    renderer->render();
+    m_renderer->render();
 }
 
 void InteractiveSession::start_render()
@@ -91,6 +100,8 @@ void InteractiveSession::end_render()
 {
     if (m_render_thread.joinable())
         m_render_thread.join();
+
+    m_render_ctrl->print_restart_statistics();
 }
 
 void InteractiveSession::schedule_camera_update(
@@ -99,3 +110,37 @@ void InteractiveSession::schedule_camera_update(
     m_render_ctrl->schedule_update(
         std::unique_ptr<ScheduledAction>(new CameraObjectUpdateAction(*m_project, camera)));
 }
+
+void InteractiveSession::schedule_object_update(
+    const std::string&                          assembly_name,
+    std::unique_ptr<asr::ObjectContainer>       objects)
+{
+    m_render_ctrl->schedule_update(
+        std::unique_ptr<ScheduledAction>(new ObjectUpdateAction(*m_project, assembly_name, std::move(objects))));
+}
+
+bool InteractiveSession::schedule_settings_update(
+    const RendererSettings&                     settings)
+{
+    const RendererSettings::ConfigChanges changes =
+        settings.diff_interactive_config(m_renderer_settings);
+
+    m_renderer_settings = settings;
+
+    if (changes.empty())
+        return false;
+
+    RENDERER_LOG_INFO(
+        "applying %s changed setting%s to the interactive session.",
+        asf::pretty_uint(changes.size()).c_str(),
+        changes.size() > 1 ? "s" : "");
+
+    m_render_ctrl->schedule_update(
+        std::unique_ptr<ScheduledAction>(
+            new ConfigUpdateAction(
+                m_project->configurations().get_by_name("interactive")->get_parameters(),
+                m_renderer->get_parameters(),
+                changes)));
+
+    return true;
+}
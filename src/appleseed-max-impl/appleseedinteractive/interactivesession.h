@@ -37,13 +37,16 @@
 
 // Standard headers.
 #include <memory>
+#include <string>
 #include <thread>
 
 // Forward declarations.
 namespace renderer { class Camera; }
+namespace renderer { class MasterRenderer; }
 namespace renderer { class Project; }
 class Bitmap;
 class IIRenderMgr;
+class InteractiveTileCallback;
 
 class InteractiveSession
 {
@@ -54,6 +57,8 @@ class InteractiveSession
         const RendererSettings&     settings,
         Bitmap*                     bitmap);
 
+    ~InteractiveSession();
+
     void start_render();
     void abort_render();
     void reininitialize_render();
@@ -62,6 +67,15 @@ class InteractiveSession
     void schedule_camera_update(
         foundation::auto_release_ptr<renderer::Camera>  camera);
 
+    void schedule_object_update(
+        const std::string&                              assembly_name,
+        std::unique_ptr<renderer::ObjectContainer>      objects);
+
+    // Schedule the update of the interactive configuration parameters that differ from
+    // the current settings. Return true if at least one parameter changed.
+    bool schedule_settings_update(
+        const RendererSettings&                         settings);
+
   private:
     std::unique_ptr<InteractiveRendererController>  m_render_ctrl;
     std::thread                                     m_render_thread;
@@ -69,6 +83,8 @@ class InteractiveSession
     IIRenderMgr*                                    m_iirender_mgr;
     renderer::Project*                              m_project;
     RendererSettings                                m_renderer_settings;
+    std::unique_ptr<InteractiveTileCallback>        m_tile_callback;
+    std::unique_ptr<renderer::MasterRenderer>       m_renderer;
 
     void render_thread();
 };
@@ -29,6 +29,9 @@
 // Interface header.
 #include "interactivetilecallback.h"
 
+// appleseed-max headers.
+#include "appleseedinteractive/interactiverenderercontroller.h"
+
 // 3ds Max headers.
 #include <bitmap.h>
 #include <interactiverender.h>
@@ -42,9 +45,9 @@ namespace
 }
 
 InteractiveTileCallback::InteractiveTileCallback(
-    Bitmap*                     bitmap,
-    IIRenderMgr*                iimanager,
-    asr::IRendererController*   render_controller)
+    Bitmap*                         bitmap,
+    IIRenderMgr*                    iimanager,
+    InteractiveRendererController*  render_controller)
   : TileCallback(bitmap, nullptr)
   , m_bitmap(bitmap)
   , m_iimanager(iimanager)
@@ -55,7 +58,12 @@ InteractiveTileCallback::InteractiveTileCallback(
 void InteractiveTileCallback::on_progressive_frame_update(
     const asr::Frame*           frame)
 {
+    // Don't spend time copying a frame that is about to be discarded by a restart or an abort.
+    if (m_renderer_ctrl->get_status() != asr::IRendererController::ContinueRendering)
+        return;
+
     TileCallback::on_progressive_frame_update(frame);
+    m_renderer_ctrl->on_frame_update();
 
     // Wait until UI proc gets handled to ensure class object is valid.
     m_ui_promise = std::promise<void>();
@@ -74,7 +82,9 @@ void InteractiveTileCallback::update_caller(UINT_PTR param_ptr)
 {
     auto tile_callback = reinterpret_cast<InteractiveTileCallback*>(param_ptr);
     
-    if (tile_callback->m_iimanager->IsRendering())
+    // Skip the display update if the frame became stale while the message was queued.
+    if (tile_callback->m_iimanager->IsRendering() &&
+        tile_callback->m_renderer_ctrl->get_status() == asr::IRendererController::ContinueRendering)
         tile_callback->m_iimanager->UpdateDisplay();
 
     tile_callback->m_ui_promise.set_value();
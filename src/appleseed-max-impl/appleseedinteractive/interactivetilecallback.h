@@ -40,9 +40,9 @@
 
 // Forward declarations.
 namespace renderer  { class Frame; }
-namespace renderer  { class IRendererController; }
 class Bitmap;
 class IIRenderMgr;
+class InteractiveRendererController;
 
 class InteractiveTileCallback
   : public TileCallback
@@ -51,14 +51,14 @@ class InteractiveTileCallback
     InteractiveTileCallback(
         Bitmap*                         bitmap,
         IIRenderMgr*                    iimanager,
-        renderer::IRendererController*  render_controller);
+        InteractiveRendererController*  render_controller);
 
     void on_progressive_frame_update(const renderer::Frame* frame) override;
 
   private:
     Bitmap*                             m_bitmap;
     IIRenderMgr*                        m_iimanager;
-    renderer::IRendererController*      m_renderer_ctrl;
+    InteractiveRendererController*      m_renderer_ctrl;
     std::promise<void>                  m_ui_promise;
 
     static void update_caller(UINT_PTR param_ptr);
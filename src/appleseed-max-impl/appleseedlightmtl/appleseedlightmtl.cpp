@@ -89,24 +89,29 @@ namespace
         ParamIdLightColorTexmap = 1,
         ParamIdLightPower       = 2,
         ParamIdEmissionFront    = 3,
-        ParamIdEmissionBack     = 4
+        ParamIdEmissionBack     = 4,
+        ParamIdAlpha            = 5,
+        ParamIdAlphaTexmap      = 6
     };
 
     enum TexmapId
     {
         // Changing these value WILL break compatibility.
         TexmapIdLightColor      = 0,
+        TexmapIdAlpha           = 1,
         TexmapCount             // keep last
     };
 
     const MSTR g_texmap_slot_names[TexmapCount] =
     {
-        L"Light Color"
+        L"Light Color",
+        L"Alpha"
     };
 
     const ParamId g_texmap_id_to_param_id[TexmapCount] =
     {
-        ParamIdLightColorTexmap
+        ParamIdLightColorTexmap,
+        ParamIdAlphaTexmap
     };
 
     ParamBlockDesc2 g_block_desc(
@@ -153,6 +158,16 @@ namespace
             p_ui, TYPE_CHECKBUTTON, IDC_BUTTON_EMISSION_BACK,
         p_end,
 
+        ParamIdAlpha, L"alpha", TYPE_FLOAT, P_ANIMATABLE, IDS_ALPHA,
+            p_default, 100.0f,
+            p_range, 0.0f, 100.0f,
+            p_ui, TYPE_SLIDER, EDITTYPE_FLOAT, IDC_EDIT_ALPHA, IDC_SLIDER_ALPHA, 10.0f,
+        p_end,
+        ParamIdAlphaTexmap, L"alpha_texmap", TYPE_TEXMAP, P_NO_AUTO_LABELS, IDS_TEXMAP_ALPHA,
+            p_subtexno, TexmapIdAlpha,
+            p_ui, TYPE_TEXMAPBUTTON, IDC_TEXMAP_ALPHA,
+        p_end,
+
         // --- The end ---
         p_end);
 }
@@ -169,6 +184,8 @@ AppleseedLightMtl::AppleseedLightMtl()
   , m_light_power(1.0f)
   , m_emission_front(true)
   , m_emission_back(false)
+  , m_alpha(100.0f)
+  , m_alpha_texmap(nullptr)
 {
     m_params_validity.SetEmpty();
 
@@ -307,6 +324,12 @@ void AppleseedLightMtl::SetSubTexmap(int i, Texmap* texmap)
     const auto texmap_id = static_cast<TexmapId>(i);
     const auto param_id = g_texmap_id_to_param_id[texmap_id];
     m_pblock->SetValue(param_id, 0, texmap);
+
+    IParamMap2* map = m_pblock->GetMap();
+    if (map != nullptr)
+    {
+        map->SetText(param_id, texmap == nullptr ? L"" : L"M");
+    }
 }
 
 int AppleseedLightMtl::MapSlotType(int i)
@@ -339,6 +362,9 @@ void AppleseedLightMtl::Update(TimeValue t, Interval& valid)
         m_pblock->GetValue(ParamIdEmissionBack, t, emission_back, m_params_validity);
         m_emission_back = emission_back != 0;
 
+        m_pblock->GetValue(ParamIdAlpha, t, m_alpha, m_params_validity);
+        m_pblock->GetValue(ParamIdAlphaTexmap, t, m_alpha_texmap, m_params_validity);
+
         NotifyDependents(FOREVER, PART_ALL, REFMSG_CHANGE);
     }
 
@@ -361,7 +387,10 @@ Interval AppleseedLightMtl::Validity(TimeValue t)
 
 ParamDlg* AppleseedLightMtl::CreateParamDlg(HWND hwMtlEdit, IMtlParams* imp)
 {
-    return g_appleseed_lightmtl_classdesc.CreateParamDlgs(hwMtlEdit, imp, this);
+    ParamDlg* param_dialog = g_appleseed_lightmtl_classdesc.CreateParamDlgs(hwMtlEdit, imp, this);
+    DbgAssert(m_pblock != nullptr);
+    update_map_buttons(m_pblock->GetMap());
+    return param_dialog;
 }
 
 IOResult AppleseedLightMtl::Save(ISave* isave)
@@ -513,10 +542,10 @@ asf::auto_release_ptr<asr::Material> AppleseedLightMtl::create_osl_material(
     
     shader_group->add_shader("surface", "as_max_light_material", name, 
         asr::ParamArray()
-            .insert("Color", fmt_osl_expr(to_color3f(m_light_color)))
+            .insert("Color", fmt_osl_expr(fold_color_texture(m_light_color_texmap, m_light_color, time)))
             .insert("Emission", fmt_osl_expr(m_light_power)));
 
-    std::string closure2surface_name = asf::format("{0}_closure2surface", name);
+    std::string closure2surface_name = LayerNames(name).get("closure2surface");
     shader_group.ref().add_shader("shader", "as_max_closure2surface", closure2surface_name.c_str(), asr::ParamArray());
 
     shader_group.ref().add_connection(
@@ -534,6 +563,16 @@ asf::auto_release_ptr<asr::Material> AppleseedLightMtl::create_osl_material(
     asr::ParamArray material_params;
     material_params.insert("osl_surface", shader_group_name);
 
+    const std::string instance_name =
+        insert_cutout_texture_and_instance(
+            assembly,
+            m_alpha_texmap,
+            false,
+            time);
+    if (!instance_name.empty())
+        material_params.insert("alpha_map", instance_name);
+    else material_params.insert("alpha_map", m_alpha / 100.0f);
+
     return asr::OSLMaterialFactory().create(name, material_params);
 }
 
@@ -575,6 +614,16 @@ asf::auto_release_ptr<asr::Material> AppleseedLightMtl::create_builtin_material(
     // Material.
     //
 
+    // Alpha map.
+    instance_name = insert_cutout_texture_and_instance(
+        assembly,
+        m_alpha_texmap,
+        use_max_procedural_maps,
+        time);
+    if (!instance_name.empty())
+        material_params.insert("alpha_map", instance_name);
+    else material_params.insert("alpha_map", m_alpha / 100.0f);
+
     return asr::GenericMaterialFactory().create(name, material_params);
 }
 
@@ -152,6 +152,8 @@ class AppleseedLightMtl
     float           m_light_power;
     bool            m_emission_front;
     bool            m_emission_back;
+    float           m_alpha;
+    Texmap*         m_alpha_texmap;
 };
 
 
@@ -22,6 +22,13 @@
 #define IDC_BUTTON_EMISSION_BACK            3033
 #define IDS_EMISSION_BACK                   3034
 
+#define IDC_LABEL_ALPHA                     3040
+#define IDC_EDIT_ALPHA                      3041
+#define IDC_SLIDER_ALPHA                    3042
+#define IDC_TEXMAP_ALPHA                    3043
+#define IDS_ALPHA                           3044
+#define IDS_TEXMAP_ALPHA                    3045
+
 // Next default values for new objects
 // 
 #ifdef APSTUDIO_INVOKED
@@ -664,13 +664,13 @@ asf::auto_release_ptr<asr::Material> AppleseedMetalMtl::create_osl_material(
 
     shader_group->add_shader("surface", "as_max_metal_material", name, 
         asr::ParamArray()
-            .insert("NormalReflectance", fmt_osl_expr(to_color3f(m_facing_tint_color)))
-            .insert("EdgeTint", fmt_osl_expr(to_color3f(m_edge_tint_color)))
-            .insert("Reflectance", fmt_osl_expr(m_reflectance / 100.0f))
-            .insert("Roughness", fmt_osl_expr(m_roughness / 100.0f))
-            .insert("Anisotropic", fmt_osl_expr(m_anisotropy)));
+            .insert("NormalReflectance", fmt_osl_expr(fold_color_texture(m_facing_tint_color_texmap, m_facing_tint_color, time)))
+            .insert("EdgeTint", fmt_osl_expr(fold_color_texture(m_edge_tint_color_texmap, m_edge_tint_color, time)))
+            .insert("Reflectance", fmt_osl_expr(fold_float_texture(m_reflectance_texmap, m_reflectance / 100.0f, time)))
+            .insert("Roughness", fmt_osl_expr(fold_float_texture(m_roughness_texmap, m_roughness / 100.0f, time)))
+            .insert("Anisotropic", fmt_osl_expr(fold_float_texture(m_anisotropy_texmap, m_anisotropy, time))));
 
-    std::string closure2surface_name = asf::format("{0}_closure2surface", name);
+    std::string closure2surface_name = LayerNames(name).get("closure2surface");
     shader_group.ref().add_shader("shader", "as_max_closure2surface", closure2surface_name.c_str(), asr::ParamArray());
 
     shader_group.ref().add_connection(
@@ -689,14 +689,11 @@ asf::auto_release_ptr<asr::Material> AppleseedMetalMtl::create_osl_material(
     material_params.insert("osl_surface", shader_group_name);
 
     const std::string instance_name =
-        insert_texture_and_instance(
+        insert_cutout_texture_and_instance(
             assembly,
             m_alpha_texmap,
             false,
-            time,
-            asr::ParamArray(),
-            asr::ParamArray()
-                .insert("alpha_mode", "detect"));
+            time);
     if (!instance_name.empty())
         material_params.insert("alpha_map", instance_name);
     else material_params.insert("alpha_map", m_alpha / 100.0f);
@@ -776,14 +773,11 @@ asf::auto_release_ptr<asr::Material> AppleseedMetalMtl::create_builtin_material(
     //
 
     // Alpha map.
-    instance_name = insert_texture_and_instance(
+    instance_name = insert_cutout_texture_and_instance(
         assembly,
         m_alpha_texmap,
         use_max_procedural_maps,
-        time,
-        asr::ParamArray(),
-        asr::ParamArray()
-            .insert("alpha_mode", "detect"));
+        time);
     if (!instance_name.empty())
         material_params.insert("alpha_map", instance_name);
     else material_params.insert("alpha_map", m_alpha / 100.0f);
@@ -59,7 +59,9 @@ namespace
 
     enum ParamMapId
     {
-        ParamMapIdVisibility
+        ParamMapIdVisibility,
+        ParamMapIdLOD,
+        ParamMapIdSubdivision
     };
 
     enum ParamId
@@ -76,7 +78,30 @@ namespace
         ParamIdVisibilitySSS            = 8,
         ParamIdSSSSet                   = 9,
         ParamIdOptimizeForInstancing    = 10,
-        ParamIdMediumPriority           = 11
+        ParamIdMediumPriority           = 11,
+        ParamIdLOD1Node                 = 12,
+        ParamIdLOD1Distance             = 13,
+        ParamIdLOD2Node                 = 14,
+        ParamIdLOD2Distance             = 15,
+        ParamIdLOD3Node                 = 16,
+        ParamIdLOD3Distance             = 17,
+        ParamIdLODPerInstance           = 18,
+        ParamIdSubdivisionEnabled       = 19,
+        ParamIdSubdivisionEdgeLength    = 20,
+        ParamIdSubdivisionMaxLevels     = 21
+    };
+
+    struct LODLevel
+    {
+        ParamId     m_node;
+        ParamId     m_distance;
+    };
+
+    const LODLevel g_lod_levels[] =
+    {
+        { ParamIdLOD1Node, ParamIdLOD1Distance },
+        { ParamIdLOD2Node, ParamIdLOD2Distance },
+        { ParamIdLOD3Node, ParamIdLOD3Distance }
     };
 
     ParamBlockDesc2 g_block_desc(
@@ -91,7 +116,7 @@ namespace
         ParamBlockRefObjPropsMod,                   // parameter block's reference number
 
         // --- P_MULTIMAP arguments ---
-        1,                                          // number of rollups
+        3,                                          // number of rollups
 
         // --- P_AUTO_UI arguments for Visibility rollup ---
         ParamMapIdVisibility,
@@ -101,6 +126,22 @@ namespace
         0,                                          // rollup creation flag
         nullptr,                                    // user dialog procedure
 
+        // --- P_AUTO_UI arguments for Level of Detail rollup ---
+        ParamMapIdLOD,
+        IDD_FORMVIEW_LOD_PARAMS,                    // ID of the dialog template
+        IDS_FORMVIEW_LOD_PARAMS_TITLE,              // ID of the dialog's title string
+        0,                                          // IParamMap2 creation/deletion flag mask
+        APPENDROLL_CLOSED,                          // rollup creation flag
+        nullptr,                                    // user dialog procedure
+
+        // --- P_AUTO_UI arguments for Subdivision rollup ---
+        ParamMapIdSubdivision,
+        IDD_FORMVIEW_SUBDIVISION_PARAMS,            // ID of the dialog template
+        IDS_FORMVIEW_SUBDIVISION_PARAMS_TITLE,      // ID of the dialog's title string
+        0,                                          // IParamMap2 creation/deletion flag mask
+        APPENDROLL_CLOSED,                          // rollup creation flag
+        nullptr,                                    // user dialog procedure
+
         // --- Parameters specifications ---
 
         ParamIdVisibilityCamera, L"visibility_camera", TYPE_BOOL, 0, IDS_VISIBILITY_CAMERA,
@@ -150,6 +191,43 @@ namespace
             p_ui, ParamMapIdVisibility, TYPE_SPINNER, EDITTYPE_INT, IDS_TEXT_MEDIUM_PRIORITY, IDS_SPINNER_MEDIUM_PRIORITY, SPIN_AUTOSCALE,
             p_default, 0, p_range, -128, 127,
         p_end,
+        ParamIdLOD1Node, L"lod1_node", TYPE_INODE, 0, IDS_LOD1_NODE,
+            p_ui, ParamMapIdLOD, TYPE_PICKNODEBUTTON, IDC_PICK_LOD1_NODE,
+        p_end,
+        ParamIdLOD1Distance, L"lod1_distance", TYPE_WORLD, 0, IDS_LOD1_DISTANCE,
+            p_ui, ParamMapIdLOD, TYPE_SPINNER, EDITTYPE_UNIVERSE, IDC_TEXT_LOD1_DISTANCE, IDC_SPINNER_LOD1_DISTANCE, SPIN_AUTOSCALE,
+            p_default, 0.0f, p_range, 0.0f, 1000000.0f,
+        p_end,
+        ParamIdLOD2Node, L"lod2_node", TYPE_INODE, 0, IDS_LOD2_NODE,
+            p_ui, ParamMapIdLOD, TYPE_PICKNODEBUTTON, IDC_PICK_LOD2_NODE,
+        p_end,
+        ParamIdLOD2Distance, L"lod2_distance", TYPE_WORLD, 0, IDS_LOD2_DISTANCE,
+            p_ui, ParamMapIdLOD, TYPE_SPINNER, EDITTYPE_UNIVERSE, IDC_TEXT_LOD2_DISTANCE, IDC_SPINNER_LOD2_DISTANCE, SPIN_AUTOSCALE,
+            p_default, 0.0f, p_range, 0.0f, 1000000.0f,
+        p_end,
+        ParamIdLOD3Node, L"lod3_node", TYPE_INODE, 0, IDS_LOD3_NODE,
+            p_ui, ParamMapIdLOD, TYPE_PICKNODEBUTTON, IDC_PICK_LOD3_NODE,
+        p_end,
+        ParamIdLOD3Distance, L"lod3_distance", TYPE_WORLD, 0, IDS_LOD3_DISTANCE,
+            p_ui, ParamMapIdLOD, TYPE_SPINNER, EDITTYPE_UNIVERSE, IDC_TEXT_LOD3_DISTANCE, IDC_SPINNER_LOD3_DISTANCE, SPIN_AUTOSCALE,
+            p_default, 0.0f, p_range, 0.0f, 1000000.0f,
+        p_end,
+        ParamIdLODPerInstance, L"lod_per_instance", TYPE_BOOL, 0, IDS_LOD_PER_INSTANCE,
+            p_default, TRUE,
+            p_ui, ParamMapIdLOD, TYPE_SINGLECHECKBOX, IDC_BUTTON_LOD_PER_INSTANCE,
+        p_end,
+        ParamIdSubdivisionEnabled, L"subdivision_enabled", TYPE_BOOL, 0, IDS_SUBDIVISION_ENABLED,
+            p_default, FALSE,
+            p_ui, ParamMapIdSubdivision, TYPE_SINGLECHECKBOX, IDC_BUTTON_SUBDIVISION_ENABLED,
+        p_end,
+        ParamIdSubdivisionEdgeLength, L"subdivision_edge_length", TYPE_FLOAT, 0, IDS_SUBDIVISION_EDGE_LENGTH,
+            p_ui, ParamMapIdSubdivision, TYPE_SPINNER, EDITTYPE_FLOAT, IDC_TEXT_SUBDIVISION_EDGE_LENGTH, IDC_SPINNER_SUBDIVISION_EDGE_LENGTH, 0.1f,
+            p_default, 4.0f, p_range, 0.5f, 100.0f,
+        p_end,
+        ParamIdSubdivisionMaxLevels, L"subdivision_max_levels", TYPE_INT, 0, IDS_SUBDIVISION_MAX_LEVELS,
+            p_ui, ParamMapIdSubdivision, TYPE_SPINNER, EDITTYPE_INT, IDC_TEXT_SUBDIVISION_MAX_LEVELS, IDC_SPINNER_SUBDIVISION_MAX_LEVELS, SPIN_AUTOSCALE,
+            p_default, 3, p_range, 0, 6,
+        p_end,
 
         // --- The end ---
         p_end);
@@ -362,6 +440,66 @@ int AppleseedObjPropsMod::get_medium_priority(const TimeValue t) const
    return m_pblock->GetInt(ParamIdMediumPriority, t, FOREVER);
 }
 
+INode* AppleseedObjPropsMod::get_lod_node(INode* node, const float distance, const TimeValue t) const
+{
+    INode* lod_node = node;
+    float lod_distance = 0.0f;
+
+    // Pick the level with the largest distance threshold not exceeding the camera distance.
+    for (const auto& level : g_lod_levels)
+    {
+        INode* level_node = m_pblock->GetINode(level.m_node, t);
+        const float level_distance = m_pblock->GetFloat(level.m_distance, t, FOREVER);
+
+        if (level_node != nullptr &&
+            level_node != node &&
+            level_distance > lod_distance &&
+            distance >= level_distance)
+        {
+            lod_node = level_node;
+            lod_distance = level_distance;
+        }
+    }
+
+    return lod_node;
+}
+
+void AppleseedObjPropsMod::get_lod_nodes(const TimeValue t, std::vector<INode*>& nodes) const
+{
+    for (const auto& level : g_lod_levels)
+    {
+        INode* level_node = m_pblock->GetINode(level.m_node, t);
+        if (level_node != nullptr)
+            nodes.push_back(level_node);
+    }
+}
+
+bool AppleseedObjPropsMod::is_lod_per_instance(const TimeValue t) const
+{
+    return m_pblock->GetInt(ParamIdLODPerInstance, t, FOREVER) != 0;
+}
+
+bool AppleseedObjPropsMod::is_subdivision_enabled(const TimeValue t) const
+{
+    return m_pblock->GetInt(ParamIdSubdivisionEnabled, t, FOREVER) != 0;
+}
+
+size_t AppleseedObjPropsMod::get_subdivision_levels(const float edge_length_in_pixels, const TimeValue t) const
+{
+    if (!is_subdivision_enabled(t))
+        return 0;
+
+    const float target_edge_length = m_pblock->GetFloat(ParamIdSubdivisionEdgeLength, t, FOREVER);
+    const int max_levels = m_pblock->GetInt(ParamIdSubdivisionMaxLevels, t, FOREVER);
+
+    // Each level halves the length of edges.
+    int levels = 0;
+    for (float length = edge_length_in_pixels; length > target_edge_length && levels < max_levels; length *= 0.5f)
+        ++levels;
+
+    return static_cast<size_t>(levels);
+}
+
 
 //
 // AppleseedObjPropsModClassDesc class implementation.
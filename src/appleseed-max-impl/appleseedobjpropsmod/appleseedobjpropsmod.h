@@ -43,6 +43,11 @@
 #include <strclass.h>
 #undef base_type
 
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
 class AppleseedObjPropsMod
   : public OSModifier
 {
@@ -96,6 +101,23 @@ class AppleseedObjPropsMod
     std::string get_sss_set(const TimeValue t) const;
     int get_medium_priority(const TimeValue t) const;
 
+    // Return the node whose geometry should be rendered in place of `node` when seen
+    // from `distance` world units away, or `node` itself if no level of detail applies.
+    INode* get_lod_node(INode* node, const float distance, const TimeValue t) const;
+
+    // Append the nodes used as levels of detail to `nodes`.
+    void get_lod_nodes(const TimeValue t, std::vector<INode*>& nodes) const;
+
+    // Return true if the level of detail is selected for each instance separately
+    // rather than once for all instances of the object.
+    bool is_lod_per_instance(const TimeValue t) const;
+
+    bool is_subdivision_enabled(const TimeValue t) const;
+
+    // Return the number of subdivision levels needed to bring edges currently spanning
+    // `edge_length_in_pixels` pixels down to the target length, or 0 if subdivision is off.
+    size_t get_subdivision_levels(const float edge_length_in_pixels, const TimeValue t) const;
+
   private:
     IParamBlock2*   m_pblock;
 };
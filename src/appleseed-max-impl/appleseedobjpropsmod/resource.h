@@ -31,6 +31,35 @@
 #define IDS_STATIC_MEDIUM_PRIORITY          7200
 #define IDS_TEXT_MEDIUM_PRIORITY            7201
 #define IDS_SPINNER_MEDIUM_PRIORITY         7202
+#define IDD_FORMVIEW_LOD_PARAMS             7300
+#define IDS_FORMVIEW_LOD_PARAMS_TITLE       7301
+#define IDC_PICK_LOD1_NODE                  7310
+#define IDS_LOD1_NODE                       7311
+#define IDC_TEXT_LOD1_DISTANCE              7312
+#define IDC_SPINNER_LOD1_DISTANCE           7313
+#define IDS_LOD1_DISTANCE                   7314
+#define IDC_PICK_LOD2_NODE                  7320
+#define IDS_LOD2_NODE                       7321
+#define IDC_TEXT_LOD2_DISTANCE              7322
+#define IDC_SPINNER_LOD2_DISTANCE           7323
+#define IDS_LOD2_DISTANCE                   7324
+#define IDC_PICK_LOD3_NODE                  7330
+#define IDS_LOD3_NODE                       7331
+#define IDC_TEXT_LOD3_DISTANCE              7332
+#define IDC_SPINNER_LOD3_DISTANCE           7333
+#define IDS_LOD3_DISTANCE                   7334
+#define IDC_BUTTON_LOD_PER_INSTANCE         7340
+#define IDS_LOD_PER_INSTANCE                7341
+#define IDD_FORMVIEW_SUBDIVISION_PARAMS     7400
+#define IDS_FORMVIEW_SUBDIVISION_PARAMS_TITLE 7401
+#define IDC_BUTTON_SUBDIVISION_ENABLED      7410
+#define IDS_SUBDIVISION_ENABLED             7411
+#define IDC_TEXT_SUBDIVISION_EDGE_LENGTH    7420
+#define IDC_SPINNER_SUBDIVISION_EDGE_LENGTH 7421
+#define IDS_SUBDIVISION_EDGE_LENGTH         7422
+#define IDC_TEXT_SUBDIVISION_MAX_LEVELS     7430
+#define IDC_SPINNER_SUBDIVISION_MAX_LEVELS  7431
+#define IDS_SUBDIVISION_MAX_LEVELS          7432
 
 // Next default values for new objects
 // 
@@ -421,11 +421,12 @@ void OSLTexture::create_osl_texture(
     const int           output_slot_index,
     const TimeValue     time)
 {
-    auto layer_name = asf::format("{0}_{1}", material_node_name, material_input_name);
+    const LayerNames layer_names(material_node_name, material_input_name);
+    const auto& layer_name = layer_names.base();
 
     if (m_has_uv_coords)
     {
-        auto uv_transform_layer_name = asf::format("{0}_{1}_uv_transform", material_node_name, material_input_name);
+        auto uv_transform_layer_name = layer_names.get("uv_transform");
         shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(this, time));
 
         auto* uv_coord_input = m_shader_info->find_maya_attribute("uvCoord");
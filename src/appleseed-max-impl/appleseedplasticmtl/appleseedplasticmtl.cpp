@@ -685,16 +685,16 @@ asf::auto_release_ptr<asr::Material> AppleseedPlasticMtl::create_osl_material(
 
     shader_group->add_shader("surface", "as_max_plastic_material", name, 
         asr::ParamArray()
-            .insert("SpecularColor", fmt_osl_expr(to_color3f(m_specular)))
+            .insert("SpecularColor", fmt_osl_expr(fold_color_texture(m_specular_texmap, m_specular, time)))
             .insert("SpecularWeight", fmt_osl_expr(m_specular_weight / 100.0f))
-            .insert("DiffuseColor", fmt_osl_expr(to_color3f(m_diffuse)))
+            .insert("DiffuseColor", fmt_osl_expr(fold_color_texture(m_diffuse_texmap, m_diffuse, time)))
             .insert("DiffuseWeight", fmt_osl_expr(m_diffuse_weight / 100.0f))
-            .insert("Roughness", fmt_osl_expr(m_roughness / 100.0f))
+            .insert("Roughness", fmt_osl_expr(fold_float_texture(m_roughness_texmap, m_roughness / 100.0f, time)))
             .insert("Spread", fmt_osl_expr(m_highlight_falloff / 100.0f))
             .insert("Scattering", fmt_osl_expr(m_scattering / 100.0f))
             .insert("IOR", fmt_osl_expr(m_ior)));
 
-    std::string closure2surface_name = asf::format("{0}_closure2surface", name);
+    std::string closure2surface_name = LayerNames(name).get("closure2surface");
     shader_group.ref().add_shader("shader", "as_max_closure2surface", closure2surface_name.c_str(), asr::ParamArray());
 
     shader_group.ref().add_connection(
@@ -713,14 +713,11 @@ asf::auto_release_ptr<asr::Material> AppleseedPlasticMtl::create_osl_material(
     material_params.insert("osl_surface", shader_group_name);
 
     const std::string instance_name =
-        insert_texture_and_instance(
+        insert_cutout_texture_and_instance(
             assembly,
             m_alpha_texmap,
             false,
-            time,
-            asr::ParamArray(),
-            asr::ParamArray()
-                .insert("alpha_mode", "detect"));
+            time);
     if (!instance_name.empty())
         material_params.insert("alpha_map", instance_name);
     else material_params.insert("alpha_map", m_alpha / 100.0f);
@@ -789,14 +786,11 @@ asf::auto_release_ptr<asr::Material> AppleseedPlasticMtl::create_builtin_materia
     //
 
     // Alpha map.
-    instance_name = insert_texture_and_instance(
+    instance_name = insert_cutout_texture_and_instance(
         assembly,
         m_alpha_texmap,
         use_max_procedural_maps,
-        time,
-        asr::ParamArray(),
-        asr::ParamArray()
-            .insert("alpha_mode", "detect"));
+        time);
     if (!instance_name.empty())
         material_params.insert("alpha_map", instance_name);
     else material_params.insert("alpha_map", m_alpha / 100.0f);
@@ -35,8 +35,13 @@
 #include "appleseedrenderer/appleseedrendererparamdlg.h"
 #include "appleseedrenderer/datachunks.h"
 #include "appleseedrenderer/dialoglogtarget.h"
+#include "appleseedrenderer/memoryreport.h"
+#include "appleseedrenderer/previewsequence.h"
 #include "appleseedrenderer/projectbuilder.h"
 #include "appleseedrenderer/renderercontroller.h"
+#include "appleseedrenderer/renderstatistics.h"
+#include "appleseedrenderer/shadingcostreport.h"
+#include "appleseedrenderer/texturesystem.h"
 #include "appleseedrenderer/tilecallback.h"
 #include "main.h"
 #include "resource.h"
@@ -45,6 +50,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/api/frame.h"
+#include "renderer/api/log.h"
 #include "renderer/api/project.h"
 #include "renderer/api/rendering.h"
 
@@ -55,6 +61,7 @@
 #include "foundation/platform/types.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/kvpair.h"
+#include "foundation/utility/string.h"
 
 // 3ds Max headers.
 #include <assert1.h>
@@ -66,9 +73,15 @@
 #include <renderelements.h>
 
 // Standard headers.
+#include <algorithm>
+#include <chrono>
 #include <clocale>
 #include <cstddef>
+#include <memory>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace asf = foundation;
 namespace asr = renderer;
@@ -170,7 +183,21 @@ namespace
         ParamIdUseMaxProcedurals                        = 19,
         ParamIdEnableLowPriority                        = 20,
         ParamIdEnableEmbree                             = 24,
-        ParamIdTextureCacheSize                         = 53
+        ParamIdTextureCacheSize                         = 53,
+        ParamIdUseTextureVariants                       = 74,
+        ParamIdLogMemoryUsage                           = 75,
+        ParamIdWriteMemoryReport                        = 76,
+        ParamIdEnableShadingCostReport                  = 77,
+        ParamIdEnableStandins                           = 78,
+        ParamIdStandinSize                              = 79,
+        ParamIdUseMeshCache                             = 80,
+        ParamIdMeshCacheSize                            = 81,
+        ParamIdBakeBumpMaps                             = 82,
+        ParamIdPreviewSequenceFrames                    = 83,
+        ParamIdCutoutAlphaMaps                          = 84,
+        ParamIdOSLTextureCacheSize                      = 85,
+        ParamIdOSLTextureMaxOpenFiles                   = 86,
+        ParamIdOSLTextureAutomip                        = 87
     };
     
     const asf::KeyValuePair<int, const wchar_t*> g_dialog_strings[] =
@@ -613,6 +640,62 @@ void AppleseedRendererPBlockAccessor::Get(
         v.i = static_cast<int>(settings.m_texture_cache_size);
         break;
 
+      case ParamIdUseTextureVariants:
+        v.i = static_cast<int>(settings.m_use_texture_variants);
+        break;
+
+      case ParamIdLogMemoryUsage:
+        v.i = static_cast<int>(settings.m_log_memory_usage);
+        break;
+
+      case ParamIdWriteMemoryReport:
+        v.i = static_cast<int>(settings.m_write_memory_report);
+        break;
+
+      case ParamIdEnableShadingCostReport:
+        v.i = static_cast<int>(settings.m_enable_shading_cost_report);
+        break;
+
+      case ParamIdEnableStandins:
+        v.i = static_cast<int>(settings.m_enable_standins);
+        break;
+
+      case ParamIdStandinSize:
+        v.f = settings.m_standin_size;
+        break;
+
+      case ParamIdUseMeshCache:
+        v.i = static_cast<int>(settings.m_use_mesh_cache);
+        break;
+
+      case ParamIdMeshCacheSize:
+        v.i = static_cast<int>(settings.m_mesh_cache_size);
+        break;
+
+      case ParamIdBakeBumpMaps:
+        v.i = static_cast<int>(settings.m_bake_bump_maps);
+        break;
+
+      case ParamIdPreviewSequenceFrames:
+        v.i = static_cast<int>(settings.m_preview_sequence_frames);
+        break;
+
+      case ParamIdCutoutAlphaMaps:
+        v.i = static_cast<int>(settings.m_cutout_alpha_maps);
+        break;
+
+      case ParamIdOSLTextureCacheSize:
+        v.i = static_cast<int>(settings.m_osl_texture_cache_size);
+        break;
+
+      case ParamIdOSLTextureMaxOpenFiles:
+        v.i = static_cast<int>(settings.m_osl_texture_max_open_files);
+        break;
+
+      case ParamIdOSLTextureAutomip:
+        v.i = static_cast<int>(settings.m_osl_texture_automip);
+        break;
+
       default:
         break;
     }
@@ -954,9 +1037,69 @@ void AppleseedRendererPBlockAccessor::Set(
         settings.m_texture_cache_size = v.i;
         break;
 
+      case ParamIdUseTextureVariants:
+        settings.m_use_texture_variants = v.i > 0;
+        break;
+
+      case ParamIdLogMemoryUsage:
+        settings.m_log_memory_usage = v.i > 0;
+        break;
+
+      case ParamIdWriteMemoryReport:
+        settings.m_write_memory_report = v.i > 0;
+        break;
+
+      case ParamIdEnableShadingCostReport:
+        settings.m_enable_shading_cost_report = v.i > 0;
+        break;
+
+      case ParamIdEnableStandins:
+        settings.m_enable_standins = v.i > 0;
+        break;
+
+      case ParamIdStandinSize:
+        settings.m_standin_size = v.f;
+        break;
+
+      case ParamIdUseMeshCache:
+        settings.m_use_mesh_cache = v.i > 0;
+        break;
+
+      case ParamIdMeshCacheSize:
+        settings.m_mesh_cache_size = v.i;
+        break;
+
+      case ParamIdBakeBumpMaps:
+        settings.m_bake_bump_maps = v.i > 0;
+        break;
+
+      case ParamIdPreviewSequenceFrames:
+        settings.m_preview_sequence_frames = v.i;
+        break;
+
+      case ParamIdCutoutAlphaMaps:
+        settings.m_cutout_alpha_maps = v.i > 0;
+        break;
+
+      case ParamIdOSLTextureCacheSize:
+        settings.m_osl_texture_cache_size = v.i;
+        break;
+
+      case ParamIdOSLTextureMaxOpenFiles:
+        settings.m_osl_texture_max_open_files = v.i;
+        break;
+
+      case ParamIdOSLTextureAutomip:
+        settings.m_osl_texture_automip = v.i > 0;
+        break;
+
       default:
         break;
     }
+
+    // Forward the change to a running ActiveShade session instead of waiting for it to be restarted.
+    if (renderer->m_interactive_renderer != nullptr)
+        renderer->m_interactive_renderer->mark_settings_dirty(settings);
 }
 
 AppleseedRendererClassDesc g_appleseed_renderer_classdesc;
@@ -1553,6 +1696,95 @@ ParamBlockDesc2 g_param_block_desc(
         p_accessor, &g_pblock_accessor,
     p_end,
 
+    ParamIdUseTextureVariants, L"use_texture_variants", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_USE_TEXTURE_VARIANTS,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdLogMemoryUsage, L"log_memory_usage", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_LOG_MEMORY_USAGE,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdWriteMemoryReport, L"write_memory_report", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_WRITE_MEMORY_REPORT,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdEnableShadingCostReport, L"enable_shading_cost_report", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_ENABLE_SHADING_COST_REPORT,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdEnableStandins, L"enable_standins", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_ENABLE_STANDINS,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdStandinSize, L"standin_size", TYPE_FLOAT, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SPINNER, EDITTYPE_FLOAT, IDC_TEXT_STANDIN_SIZE, IDC_SPINNER_STANDIN_SIZE, SPIN_AUTOSCALE,
+        p_default, 2.0f,
+        p_range, 0.0f, 1000.0f,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdUseMeshCache, L"use_mesh_cache", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_USE_MESH_CACHE,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdMeshCacheSize, L"mesh_cache_size", TYPE_INT, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SPINNER, EDITTYPE_INT, IDC_TEXT_MESH_CACHE_SIZE, IDC_SPINNER_MESH_CACHE_SIZE, SPIN_AUTOSCALE,
+        p_default, 4096,
+        p_range, 1, 1024*1024,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdBakeBumpMaps, L"bake_bump_maps", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_BAKE_BUMP_MAPS,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdPreviewSequenceFrames, L"preview_sequence_frames", TYPE_INT, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SPINNER, EDITTYPE_INT, IDC_TEXT_PREVIEW_SEQUENCE_FRAMES, IDC_SPINNER_PREVIEW_SEQUENCE_FRAMES, SPIN_AUTOSCALE,
+        p_default, 1,
+        p_range, 1, 16,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdCutoutAlphaMaps, L"cutout_alpha_maps", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_CUTOUT_ALPHA_MAPS,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdOSLTextureCacheSize, L"osl_texture_cache_size", TYPE_INT, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SPINNER, EDITTYPE_INT, IDC_TEXT_OSL_TEXTURE_CACHE_SIZE, IDC_SPINNER_OSL_TEXTURE_CACHE_SIZE, SPIN_AUTOSCALE,
+        p_default, 1024,
+        p_range, 1, 1024*1024,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdOSLTextureMaxOpenFiles, L"osl_texture_max_open_files", TYPE_INT, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SPINNER, EDITTYPE_INT, IDC_TEXT_OSL_TEXTURE_MAX_OPEN_FILES, IDC_SPINNER_OSL_TEXTURE_MAX_OPEN_FILES, SPIN_AUTOSCALE,
+        p_default, 100,
+        p_range, 10, 10000,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
+    ParamIdOSLTextureAutomip, L"osl_texture_automip", TYPE_BOOL, P_TRANSIENT, 0,
+        p_ui, ParamMapIdSystem, TYPE_SINGLECHEKBOX, IDC_CHECK_OSL_TEXTURE_AUTOMIP,
+        p_default, FALSE,
+        p_accessor, &g_pblock_accessor,
+    p_end,
+
     p_end
 );
 
@@ -1569,6 +1801,7 @@ AppleseedRenderer::AppleseedRenderer()
   : m_settings(RendererSettings::defaults())
   , m_interactive_renderer(nullptr)
   , m_param_block(nullptr)
+  , m_sequence_frame_count(0)
 {
     g_appleseed_renderer_classdesc.MakeAutoParamBlocks(this);
     clear();
@@ -1810,6 +2043,10 @@ int AppleseedRenderer::Open(
     for (int i = 0; i < default_light_count; ++i)
         m_default_lights.push_back(default_lights[i]);
 
+    m_preview_frames.clear();
+    m_sequence_frame_count = 0;
+    m_sequence_start_time = std::chrono::steady_clock::now();
+
     return 1;   // success
 }
 
@@ -1933,7 +2170,8 @@ namespace
         asr::Project&           project,
         const RendererSettings& settings,
         Bitmap*                 bitmap,
-        RendProgressCallback*   progress_cb)
+        RendProgressCallback*   progress_cb,
+        RenderStatistics*       statistics = nullptr)
     {
         // Number of rendered tiles, shared counter accessed atomically.
         volatile asf::uint32 rendered_tile_count = 0;
@@ -1961,6 +2199,14 @@ namespace
         // Render the frame.
         renderer->render();
 
+        if (statistics != nullptr)
+        {
+            statistics->m_scene_preparation_time = renderer_controller.get_scene_preparation_time();
+            statistics->m_frame_time = renderer_controller.get_frame_time();
+            statistics->m_pixel_count = project.get_frame()->image().properties().m_pixel_count;
+            statistics->m_rendered_tile_count = static_cast<size_t>(rendered_tile_count);
+        }
+
         return renderer_controller.get_status();
 
         // Make sure the master renderer is deleted before the project.
@@ -2009,6 +2255,32 @@ int AppleseedRenderer::Render(
     if (!m_rend_params.inMtlEdit || m_settings.m_log_material_editor_messages)
         create_log_window();
 
+    // Hand over frames that were rendered ahead of time by a preview batch.
+    const auto preview_frame =
+        std::find_if(
+            m_preview_frames.begin(),
+            m_preview_frames.end(),
+            [time](const std::unique_ptr<PreviewFrame>& frame) { return frame->m_time == time; });
+    if (preview_frame != m_preview_frames.end())
+    {
+        // Render frame notifications were sent when the frame was built and rendered.
+        bitmap->CopyImage((*preview_frame)->m_bitmap, COPY_IMAGE_CROP, BMM_Color_fl(0.0f, 0.0f, 0.0f, 0.0f));
+        bitmap->RefreshWindow();
+
+        if (!GetCOREInterface14()->GetRendUseIterative())
+            (*preview_frame)->m_project->get_frame()->write_main_and_aov_images();
+
+        m_preview_frames.erase(preview_frame);
+        ++m_sequence_frame_count;
+
+        std::setlocale(LC_ALL, previous_locale.c_str());
+
+        return 1;
+    }
+
+    // Frames of an interrupted batch will never be asked for.
+    m_preview_frames.clear();
+
     TimeValue eval_time = time;
     BroadcastNotification(NOTIFY_RENDER_PREEVAL, &eval_time);
 
@@ -2025,6 +2297,7 @@ int AppleseedRenderer::Render(
     // Build the project.
     if (progress_cb)
         progress_cb->SetTitle(L"Building Project...");
+    const auto build_start_time = std::chrono::steady_clock::now();
     asf::auto_release_ptr<asr::Project> project(
         build_project(
             m_entities,
@@ -2037,6 +2310,14 @@ int AppleseedRenderer::Render(
             bitmap,
             time,
             progress_cb));
+    const std::chrono::duration<double> build_time =
+        std::chrono::steady_clock::now() - build_start_time;
+
+    RenderStatistics statistics;
+    statistics.m_build_time = build_time.count();
+
+    if (renderer_settings.m_log_memory_usage)
+        report_memory_usage(project.ref(), renderer_settings, "project build", renderer_settings.m_write_memory_report);
 
     if (m_rend_params.inMtlEdit)
     {
@@ -2056,11 +2337,30 @@ int AppleseedRenderer::Render(
             if (m_settings.m_output_mode == RendererSettings::OutputMode::SaveProjectOnly ||
                 m_settings.m_output_mode == RendererSettings::OutputMode::SaveProjectAndRender)
             {
-                if (progress_cb)
-                    progress_cb->SetTitle(L"Writing Project To Disk...");
-                asr::ProjectFileWriter::write(
-                    project.ref(),
-                    wide_to_utf8(m_settings.m_project_file_path).c_str());
+                if (m_settings.m_output_mode == RendererSettings::OutputMode::SaveProjectOnly &&
+                    is_rendering_sequence())
+                {
+                    // Serialize the frames of a sequence in the background while 3ds Max builds the next ones.
+                    if (m_sequence_exporter == nullptr)
+                    {
+                        m_sequence_exporter.reset(
+                            new SequenceProjectExporter(
+                                std::wstring(m_settings.m_project_file_path),
+                                std::max(std::thread::hardware_concurrency(), 2U) - 1));
+                    }
+
+                    if (progress_cb)
+                        progress_cb->SetTitle(L"Queuing Project For Writing...");
+                    m_sequence_exporter->write(time / GetTicksPerFrame(), project);
+                }
+                else
+                {
+                    if (progress_cb)
+                        progress_cb->SetTitle(L"Writing Project To Disk...");
+                    asr::ProjectFileWriter::write(
+                        project.ref(),
+                        wide_to_utf8(m_settings.m_project_file_path).c_str());
+                }
             }
         }
 
@@ -2080,6 +2380,27 @@ int AppleseedRenderer::Render(
 
             auto render_status = asr::IRendererController::Status::ContinueRendering;
 
+            // Render the following frames of a preview sequence together with this one.
+            std::vector<TimeValue> batch_times(1, time);
+            if (m_settings.m_preview_sequence_frames > 1 &&
+                m_settings.m_output_mode == RendererSettings::OutputMode::RenderOnly)
+            {
+                batch_times =
+                    get_sequence_frame_times(
+                        time,
+                        static_cast<size_t>(m_settings.m_preview_sequence_frames));
+            }
+
+            const auto render_frames = [&]()
+            {
+                return
+                    batch_times.size() > 1
+                        ? render_preview_batch(project, batch_times, renderer_settings, frame_rend_params, bitmap, progress_cb)
+                        : render(project.ref(), m_settings, bitmap, progress_cb, &statistics);
+            };
+
+            configure_texture_system(m_settings);
+
             if (progress_cb)
                 progress_cb->SetTitle(L"Rendering...");
             if (m_settings.m_low_priority_mode)
@@ -2087,11 +2408,21 @@ int AppleseedRenderer::Render(
                 asf::ProcessPriorityContext background_context(
                     asf::ProcessPriority::ProcessPriorityLow,
                     &asr::global_logger());
-                render_status = render(project.ref(), m_settings, bitmap, progress_cb);
+                render_status = render_frames();
             }
             else
             {
-                render_status = render(project.ref(), m_settings, bitmap, progress_cb);
+                render_status = render_frames();
+            }
+
+            // Concurrent preview frames are not timed individually: don't summarize them.
+            if (render_status != asr::IRendererController::Status::AbortRendering && batch_times.size() == 1)
+                print_render_summary(statistics, m_settings);
+
+            if (render_status != asr::IRendererController::Status::AbortRendering)
+            {
+                report_texture_system_statistics();
+                ++m_sequence_frame_count;
             }
 
             if (render_status != asr::IRendererController::Status::AbortRendering &&
@@ -2099,9 +2430,30 @@ int AppleseedRenderer::Render(
                 project->get_frame()->write_main_and_aov_images();
 
             BroadcastNotification(NOTIFY_POST_RENDERFRAME, &render_context);
+
+            if (m_settings.m_enable_shading_cost_report &&
+                render_status != asr::IRendererController::Status::AbortRendering)
+                report_shading_cost(project.ref());
+
+            if (m_settings.m_log_memory_usage)
+            {
+                TextureSystemStatistics texture_statistics;
+                const bool has_texture_statistics = get_texture_system_statistics(texture_statistics);
+
+                report_memory_usage(
+                    project.ref(),
+                    m_settings,
+                    "rendering",
+                    m_settings.m_write_memory_report,
+                    has_texture_statistics ? &texture_statistics : nullptr);
+            }
         }
     }
 
+    // Call RenderEnd() on the object instances of this frame.
+    render_end(m_entities.m_objects, time);
+    m_entities.clear();
+
     if (progress_cb)
         progress_cb->SetTitle(L"Done.");
 
@@ -2111,12 +2463,129 @@ int AppleseedRenderer::Render(
     return 1;
 }
 
+asr::IRendererController::Status AppleseedRenderer::render_preview_batch(
+    asf::auto_release_ptr<asr::Project>&    project,
+    const std::vector<TimeValue>&           times,
+    const RendererSettings&                 settings,
+    FrameRendParams&                        frame_rend_params,
+    Bitmap*                                 bitmap,
+    RendProgressCallback*                   progress_cb)
+{
+    PreviewFrameVector frames;
+
+    // The current frame renders directly to the bitmap provided by 3ds Max.
+    frames.emplace_back(new PreviewFrame(times[0], bitmap));
+    frames.back()->m_project = project;
+
+    // Render contexts and object instances of the following frames, in the same order.
+    std::vector<std::unique_ptr<AppleseedRenderContext>> render_contexts;
+    std::vector<MaxSceneEntities> frame_entities(times.size() - 1);
+
+    // Projects must be built from the main thread since they query the 3ds Max scene.
+    if (progress_cb)
+        progress_cb->SetTitle(L"Building Preview Frames...");
+    for (size_t i = 1, e = times.size(); i < e; ++i)
+    {
+        TimeValue eval_time = times[i];
+        BroadcastNotification(NOTIFY_RENDER_PREEVAL, &eval_time);
+
+        // Nodes can be animated in and out of the scene: collect the entities of every frame.
+        MaxSceneEntities& entities = frame_entities[i - 1];
+        MaxSceneEntityCollector collector(entities);
+        collector.collect(m_scene);
+        render_begin(entities.m_objects, times[i]);
+
+        ViewParams view_params = m_view_params;
+        if (m_view_node)
+            get_view_params_from_view_node(view_params, m_view_node, times[i]);
+
+        std::unique_ptr<PreviewFrame> frame(create_offscreen_preview_frame(times[i], bitmap));
+
+        // Let scripts and plugins react to the frame while its project is built.
+        render_contexts.emplace_back(
+            new AppleseedRenderContext(
+                static_cast<Renderer*>(this),
+                frame->m_bitmap,
+                m_rend_params,
+                view_params,
+                times[i]));
+
+        BroadcastNotification(NOTIFY_PRE_RENDERFRAME, render_contexts.back().get());
+
+        frame->m_project =
+            build_project(
+                entities,
+                m_default_lights,
+                m_view_node,
+                view_params,
+                m_rend_params,
+                frame_rend_params,
+                settings,
+                frame->m_bitmap,
+                times[i],
+                progress_cb);
+
+        frames.push_back(std::move(frame));
+    }
+
+    if (progress_cb)
+        progress_cb->SetTitle(L"Rendering...");
+    const auto render_status = render_preview_frames(frames, settings, progress_cb);
+
+    // The following frames are rendered: end them like the current frame will be.
+    for (size_t i = 1, e = times.size(); i < e; ++i)
+    {
+        BroadcastNotification(NOTIFY_POST_RENDERFRAME, render_contexts[i - 1].get());
+        render_end(frame_entities[i - 1].m_objects, times[i]);
+    }
+
+    // Give the current frame's project back and keep the other frames for the next calls to Render().
+    project = frames.front()->m_project;
+    frames.erase(frames.begin());
+
+    if (render_status != asr::IRendererController::Status::AbortRendering)
+    {
+        for (auto& frame : frames)
+            m_preview_frames.push_back(std::move(frame));
+    }
+
+    return render_status;
+}
+
+void AppleseedRenderer::print_sequence_statistics() const
+{
+    if (m_sequence_frame_count < 2)
+        return;
+
+    const std::chrono::duration<double> sequence_time =
+        std::chrono::steady_clock::now() - m_sequence_start_time;
+    const size_t concurrent_frames =
+        m_settings.m_output_mode == RendererSettings::OutputMode::RenderOnly
+            ? static_cast<size_t>(m_settings.m_preview_sequence_frames)
+            : 1;
+
+    RENDERER_LOG_INFO(
+        "rendered %s frames in %s (%s frames per minute, %s frame%s at a time).",
+        asf::pretty_uint(m_sequence_frame_count).c_str(),
+        asf::pretty_time(sequence_time.count()).c_str(),
+        asf::pretty_scalar(m_sequence_frame_count * 60.0 / sequence_time.count(), 1).c_str(),
+        asf::pretty_uint(concurrent_frames).c_str(),
+        concurrent_frames > 1 ? "s" : "");
+}
+
 void AppleseedRenderer::Close(
     HWND                    hwnd,
     RendProgressCallback*   progress_cb)
 {
-    // Call RenderEnd() on all object instances.
-    render_end(m_entities.m_objects, m_time);
+    print_sequence_statistics();
+
+    // Wait for the projects of the sequence to be written.
+    if (m_sequence_exporter != nullptr)
+    {
+        if (progress_cb)
+            progress_cb->SetTitle(L"Writing Projects To Disk...");
+        m_sequence_exporter.reset();
+    }
 
     clear();
 
@@ -2242,6 +2711,7 @@ void AppleseedRenderer::clear()
     m_default_lights.clear();
     m_time = 0;
     m_entities.clear();
+    m_preview_frames.clear();
 }
 
 
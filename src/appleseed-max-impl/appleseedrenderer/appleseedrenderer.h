@@ -30,7 +30,9 @@
 
 // appleseed-max headers.
 #include "appleseedrenderer/maxsceneentities.h"
+#include "appleseedrenderer/previewsequence.h"
 #include "appleseedrenderer/renderersettings.h"
+#include "appleseedrenderer/sequenceexporter.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/windows.h"    // include before 3ds Max headers
@@ -43,6 +45,9 @@
 #undef base_type
 
 // Standard headers.
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 // Windows headers.
@@ -187,6 +192,26 @@ class AppleseedRenderer
     MaxSceneEntities            m_entities;
     IParamBlock2*               m_param_block;
 
+    // Frames rendered ahead of time by a preview batch, waiting for 3ds Max to ask for them.
+    PreviewFrameVector          m_preview_frames;
+
+    // Frame rate of the current animation sequence.
+    size_t                      m_sequence_frame_count;
+    std::chrono::steady_clock::time_point m_sequence_start_time;
+
+    // Writes the projects of an animation sequence in SaveProjectOnly mode.
+    std::unique_ptr<SequenceProjectExporter> m_sequence_exporter;
+
+    renderer::IRendererController::Status render_preview_batch(
+        foundation::auto_release_ptr<renderer::Project>&    project,
+        const std::vector<TimeValue>&                       times,
+        const RendererSettings&                             settings,
+        FrameRendParams&                                    frame_rend_params,
+        Bitmap*                                             bitmap,
+        RendProgressCallback*                               progress_cb);
+
+    void print_sequence_statistics() const;
+
     void clear();
 };
 
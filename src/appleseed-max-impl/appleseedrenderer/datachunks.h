@@ -92,6 +92,20 @@ const USHORT ChunkSettingsSystemEnableRenderStamp                   = 0x1440;
 const USHORT ChunkSettingsSystemRenderStampString                   = 0x1450;
 const USHORT ChunkSettingsSystemEnableEmbree                        = 0x1460;
 const USHORT ChunkSettingsSystemTextureCacheSize                    = 0x1470;
+const USHORT ChunkSettingsSystemUseTextureVariants                  = 0x1480;
+const USHORT ChunkSettingsSystemLogMemoryUsage                      = 0x1490;
+const USHORT ChunkSettingsSystemWriteMemoryReport                   = 0x14A0;
+const USHORT ChunkSettingsSystemEnableShadingCostReport             = 0x14B0;
+const USHORT ChunkSettingsSystemEnableStandins                      = 0x14C0;
+const USHORT ChunkSettingsSystemStandinSize                         = 0x14D0;
+const USHORT ChunkSettingsSystemUseMeshCache                        = 0x14E0;
+const USHORT ChunkSettingsSystemMeshCacheSize                       = 0x14F0;
+const USHORT ChunkSettingsSystemBakeBumpMaps                        = 0x1500;
+const USHORT ChunkSettingsSystemPreviewSequenceFrames               = 0x1510;
+const USHORT ChunkSettingsSystemCutoutAlphaMaps                     = 0x1520;
+const USHORT ChunkSettingsSystemOSLTextureCacheSize                 = 0x1530;
+const USHORT ChunkSettingsSystemOSLTextureMaxOpenFiles              = 0x1540;
+const USHORT ChunkSettingsSystemOSLTextureAutomip                   = 0x1550;
 
 const USHORT ChunkSettingsPostprocessing                            = 0x1500;
 const USHORT ChunkSettingsPostprocessingDenoiseMode                 = 0x1501;
@@ -0,0 +1,154 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "mappedfile.h"
+
+// Standard headers.
+#include <algorithm>
+
+namespace asf = foundation;
+
+MappedFileReader::MappedFileReader(const wchar_t* path)
+  : m_mapping(nullptr)
+  , m_size(0)
+  , m_position(0)
+  , m_view(nullptr)
+  , m_view_begin(0)
+  , m_view_end(0)
+  , m_granularity(0)
+{
+    // Allow other processes to replace the file while it is mapped. Files that can't be
+    // opened for writing attributes, e.g. on read-only shares, are still mapped.
+    const DWORD share_mode = FILE_SHARE_READ | FILE_SHARE_DELETE;
+    m_file =
+        CreateFileW(
+            path,
+            GENERIC_READ | FILE_WRITE_ATTRIBUTES,
+            share_mode,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        m_file =
+            CreateFileW(
+                path,
+                GENERIC_READ,
+                share_mode,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN,
+                nullptr);
+    }
+
+    if (m_file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+        return;
+    m_size = static_cast<asf::uint64>(size.QuadPart);
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    // Views must start at a multiple of the allocation granularity.
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    m_granularity = system_info.dwAllocationGranularity;
+}
+
+MappedFileReader::~MappedFileReader()
+{
+    if (m_view != nullptr)
+        UnmapViewOfFile(m_view);
+
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+}
+
+bool MappedFileReader::is_open() const
+{
+    return m_mapping != nullptr;
+}
+
+asf::uint64 MappedFileReader::get_size() const
+{
+    return m_size;
+}
+
+asf::uint64 MappedFileReader::get_remaining_size() const
+{
+    return m_size - m_position;
+}
+
+const void* MappedFileReader::read(const size_t size)
+{
+    if (m_mapping == nullptr || size > MaxReadSize || size > get_remaining_size())
+        return nullptr;
+
+    // Slide the view forward if the requested bytes aren't entirely in it.
+    if (m_view == nullptr || m_position + size > m_view_end)
+    {
+        if (m_view != nullptr)
+            UnmapViewOfFile(m_view);
+
+        m_view_begin = m_position - m_position % m_granularity;
+        m_view_end = std::min(m_view_begin + MaxReadSize + m_granularity, m_size);
+
+        const size_t view_size = static_cast<size_t>(m_view_end - m_view_begin);
+        m_view =
+            static_cast<const asf::uint8*>(
+                MapViewOfFile(
+                    m_mapping,
+                    FILE_MAP_READ,
+                    static_cast<DWORD>(m_view_begin >> 32),
+                    static_cast<DWORD>(m_view_begin & 0xFFFFFFFF),
+                    view_size));
+
+        if (m_view == nullptr)
+            return nullptr;
+    }
+
+    const void* data = m_view + (m_position - m_view_begin);
+    m_position += size;
+
+    return data;
+}
+
+void MappedFileReader::touch()
+{
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(m_file, nullptr, &now, nullptr);
+}
@@ -0,0 +1,81 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+#include "foundation/platform/windows.h"
+
+// Standard headers.
+#include <cstddef>
+
+//
+// Sequential reader of a read-only memory-mapped file. Data is read straight from the pages
+// the OS caches for the file, which are shared by all processes reading it. Only a window of
+// the file is mapped at any time so that reading a multi-gigabyte file doesn't keep all of its
+// pages in the working set of the process.
+//
+
+class MappedFileReader
+  : public foundation::NonCopyable
+{
+  public:
+    explicit MappedFileReader(const wchar_t* path);
+    ~MappedFileReader();
+
+    // Return true if the file could be opened and mapped.
+    bool is_open() const;
+
+    // Return the size of the file in bytes.
+    foundation::uint64 get_size() const;
+
+    // Return the number of bytes that remain to be read.
+    foundation::uint64 get_remaining_size() const;
+
+    // Return a pointer to the next `size` bytes of the file and move past them, or nullptr if
+    // fewer bytes remain. The pointer is valid until the next call. `size` must not exceed
+    // MaxReadSize.
+    const void* read(const size_t size);
+
+    // Set the last access time of the file to the current time.
+    void touch();
+
+    static const size_t MaxReadSize = 64 * 1024 * 1024;
+
+  private:
+    HANDLE                      m_file;
+    HANDLE                      m_mapping;
+    foundation::uint64          m_size;
+    foundation::uint64          m_position;
+    const foundation::uint8*    m_view;             // currently mapped window of the file
+    foundation::uint64          m_view_begin;
+    foundation::uint64          m_view_end;
+    foundation::uint64          m_granularity;      // alignment of window offsets
+};
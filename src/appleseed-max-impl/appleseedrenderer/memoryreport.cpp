@@ -0,0 +1,544 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "memoryreport.h"
+
+// appleseed-max headers.
+#include "appleseedrenderer/renderersettings.h"
+#include "appleseedrenderer/texturesystem.h"
+#include "oslutils.h"
+#include "utilities.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+#include "renderer/api/object.h"
+#include "renderer/api/project.h"
+#include "renderer/api/scene.h"
+#include "renderer/api/shadergroup.h"
+#include "renderer/api/texture.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/string.h"
+
+// RapidJSON headers.
+#include "3rdparty/rapidjson/prettywriter.h"
+#include "3rdparty/rapidjson/stringbuffer.h"
+
+// 3ds Max headers.
+#include <maxapi.h>
+
+// Windows headers.
+#include <Psapi.h>
+
+// Standard headers.
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace asf = foundation;
+namespace asr = renderer;
+namespace json = rapidjson;
+
+namespace
+{
+    const size_t MaxLoggedEntries = 10;
+
+    struct MemoryEntry
+    {
+        typedef std::vector<std::pair<const char*, asf::uint64>> PartVector;
+
+        const char*     m_category;
+        std::string     m_name;
+        asf::uint64     m_bytes;
+        PartVector      m_parts;
+    };
+
+    struct ShaderGroupEntry
+    {
+        std::string     m_name;
+        size_t          m_shader_count;
+        size_t          m_connection_count;
+    };
+
+    typedef std::map<std::string, asf::uint64> FileSizeMap;
+
+    struct MemoryReport
+    {
+        std::vector<MemoryEntry>        m_entries;
+        std::vector<ShaderGroupEntry>   m_shader_groups;
+        FileSizeMap                     m_cached_texture_files; // file path -> size at full resolution, 0 if unknown
+        FileSizeMap                     m_osl_texture_files;    // file path -> size at full resolution, 0 if unknown
+        asf::uint64                     m_texture_cache_budget;
+        asf::uint64                     m_osl_texture_cache_budget;
+        bool                            m_has_osl_texture_statistics;
+        TextureSystemStatistics         m_osl_texture_statistics;
+        asf::uint64                     m_working_set;
+        asf::uint64                     m_peak_working_set;
+
+        MemoryReport()
+          : m_texture_cache_budget(0)
+          , m_osl_texture_cache_budget(0)
+          , m_has_osl_texture_statistics(false)
+          , m_working_set(0)
+          , m_peak_working_set(0)
+        {
+        }
+    };
+
+    std::string make_entity_path(const std::string& parent_path, const char* name)
+    {
+        return parent_path.empty() ? std::string(name) : parent_path + "/" + name;
+    }
+
+    void collect_mesh_object(
+        const asr::MeshObject&  object,
+        const std::string&      path,
+        MemoryReport&           report)
+    {
+        const asf::uint64 vertex_bytes = object.get_vertex_count() * sizeof(asr::GVector3);
+        const asf::uint64 normal_bytes = object.get_vertex_normal_count() * sizeof(asr::GVector3);
+        const asf::uint64 tex_coords_bytes = object.get_tex_coords_count() * sizeof(asr::GVector2);
+        const asf::uint64 triangle_bytes = object.get_triangle_count() * sizeof(asr::Triangle);
+
+        // Each additional motion segment stores its own copy of the vertices and normals.
+        const asf::uint64 motion_bytes =
+            object.get_motion_segment_count() * (vertex_bytes + normal_bytes);
+
+        MemoryEntry entry;
+        entry.m_category = "mesh";
+        entry.m_name = path;
+        entry.m_bytes = vertex_bytes + normal_bytes + tex_coords_bytes + triangle_bytes + motion_bytes;
+        entry.m_parts.emplace_back("vertices", vertex_bytes);
+        entry.m_parts.emplace_back("normals", normal_bytes);
+        entry.m_parts.emplace_back("tex_coords", tex_coords_bytes);
+        entry.m_parts.emplace_back("triangles", triangle_bytes);
+        if (motion_bytes > 0)
+            entry.m_parts.emplace_back("motion_segments", motion_bytes);
+        report.m_entries.push_back(entry);
+    }
+
+    asf::uint64 get_decoded_texture_size(const std::string& filepath)
+    {
+        BitmapFileInfo info;
+        if (!probe_bitmap_file(utf8_to_wide(filepath), info))
+            return 0;
+
+        const asf::uint64 bytes_per_pixel = (info.m_channel_count * info.m_bits_per_channel + 7) / 8;
+        return static_cast<asf::uint64>(info.m_width) * info.m_height * bytes_per_pixel;
+    }
+
+    void collect_texture(
+        asr::Texture&           texture,
+        const std::string&      path,
+        MemoryReport&           report)
+    {
+        const std::string model = texture.get_model();
+
+        if (model == "memory_texture_2d")
+        {
+            // Baked images (e.g. 3ds Max procedural maps) are fully resident in memory.
+            const asf::CanvasProperties& props = texture.properties();
+
+            MemoryEntry entry;
+            entry.m_category = "image";
+            entry.m_name = path;
+            entry.m_bytes = props.m_pixel_count * props.m_pixel_size;
+            entry.m_parts.emplace_back("width", props.m_canvas_width);
+            entry.m_parts.emplace_back("height", props.m_canvas_height);
+            entry.m_parts.emplace_back("channels", props.m_channel_count);
+            report.m_entries.push_back(entry);
+        }
+        else if (model == "disk_texture_2d")
+        {
+            // Disk textures are paged in through the texture cache and share its budget.
+            const std::string filename =
+                texture.get_parameters().get_optional<std::string>("filename", "");
+            if (!filename.empty() && report.m_cached_texture_files.count(filename) == 0)
+                report.m_cached_texture_files.insert(std::make_pair(filename, get_decoded_texture_size(filename)));
+        }
+    }
+
+    void collect_shader_group(
+        const asr::ShaderGroup& shader_group,
+        const std::string&      path,
+        MemoryReport&           report)
+    {
+        // Bitmaps connected through OSL shaders are read by OpenImageIO's texture system,
+        // not by appleseed's texture store. Their file names are OSL string parameters.
+        for (const asr::Shader& shader : shader_group.shaders())
+        {
+            std::string filepath;
+            if (parse_osl_string_expr(shader.get_parameters().get_optional<std::string>("Filename", ""), filepath) &&
+                !filepath.empty() &&
+                report.m_osl_texture_files.count(filepath) == 0)
+                report.m_osl_texture_files.insert(std::make_pair(filepath, get_decoded_texture_size(filepath)));
+        }
+
+        // OSL does not expose the size of compiled shader groups; report their complexity instead.
+        ShaderGroupEntry entry;
+        entry.m_name = path;
+        entry.m_shader_count = shader_group.shaders().size();
+        entry.m_connection_count = shader_group.shader_connections().size();
+        report.m_shader_groups.push_back(entry);
+    }
+
+    void collect_base_group(
+        asr::BaseGroup&         base_group,
+        const std::string&      path,
+        MemoryReport&           report)
+    {
+        for (asr::Texture& texture : base_group.textures())
+            collect_texture(texture, make_entity_path(path, texture.get_name()), report);
+
+        for (const asr::ShaderGroup& shader_group : base_group.shader_groups())
+            collect_shader_group(shader_group, make_entity_path(path, shader_group.get_name()), report);
+    }
+
+    void collect_assembly(
+        asr::Assembly&          assembly,
+        const std::string&      parent_path,
+        MemoryReport&           report)
+    {
+        const std::string path = make_entity_path(parent_path, assembly.get_name());
+
+        collect_base_group(assembly, path, report);
+
+        for (const asr::Object& object : assembly.objects())
+        {
+            const asr::MeshObject* mesh = dynamic_cast<const asr::MeshObject*>(&object);
+            if (mesh != nullptr)
+                collect_mesh_object(*mesh, make_entity_path(path, object.get_name()), report);
+        }
+
+        for (asr::Assembly& child_assembly : assembly.assemblies())
+            collect_assembly(child_assembly, path, report);
+    }
+
+    void collect_process_memory(MemoryReport& report)
+    {
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            report.m_working_set = counters.WorkingSetSize;
+            report.m_peak_working_set = counters.PeakWorkingSetSize;
+        }
+    }
+
+    asf::uint64 get_total_bytes(const MemoryReport& report, const char* category)
+    {
+        asf::uint64 total = 0;
+
+        for (const MemoryEntry& entry : report.m_entries)
+        {
+            if (category == nullptr || std::string(entry.m_category) == category)
+                total += entry.m_bytes;
+        }
+
+        return total;
+    }
+
+    asf::uint64 get_total_bytes(const FileSizeMap& files)
+    {
+        asf::uint64 total = 0;
+
+        for (const auto& file : files)
+            total += file.second;
+
+        return total;
+    }
+
+    std::string format_parts(const MemoryEntry& entry)
+    {
+        std::string result;
+
+        for (const auto& part : entry.m_parts)
+        {
+            if (!result.empty())
+                result += ", ";
+            result += part.first;
+            result += " ";
+            result += entry.m_category == std::string("image")
+                ? asf::pretty_uint(part.second)
+                : asf::pretty_size(part.second);
+        }
+
+        return result;
+    }
+
+    void log_report(const MemoryReport& report, const char* stage)
+    {
+        RENDERER_LOG_INFO(
+            "memory usage after %s: %s in meshes, %s in baked images, %s shader group%s, "
+            "%s texture file%s (%s at full resolution) sharing a %s texture cache.",
+            stage,
+            asf::pretty_size(get_total_bytes(report, "mesh")).c_str(),
+            asf::pretty_size(get_total_bytes(report, "image")).c_str(),
+            asf::pretty_uint(report.m_shader_groups.size()).c_str(),
+            report.m_shader_groups.size() > 1 ? "s" : "",
+            asf::pretty_uint(report.m_cached_texture_files.size()).c_str(),
+            report.m_cached_texture_files.size() > 1 ? "s" : "",
+            asf::pretty_size(get_total_bytes(report.m_cached_texture_files)).c_str(),
+            asf::pretty_size(report.m_texture_cache_budget).c_str());
+
+        if (report.m_has_osl_texture_statistics && report.m_osl_texture_statistics.m_tile_lookups > 0)
+        {
+            const TextureSystemStatistics& statistics = report.m_osl_texture_statistics;
+            RENDERER_LOG_INFO(
+                "  osl texture cache: %s hit rate, %s read from %s file%s.",
+                asf::pretty_percent(statistics.m_tile_hits, statistics.m_tile_lookups).c_str(),
+                asf::pretty_size(statistics.m_bytes_read).c_str(),
+                asf::pretty_uint(statistics.m_files_opened).c_str(),
+                statistics.m_files_opened > 1 ? "s" : "");
+        }
+
+        if (!report.m_osl_texture_files.empty())
+        {
+            std::vector<std::pair<std::string, asf::uint64>> files(
+                report.m_osl_texture_files.begin(),
+                report.m_osl_texture_files.end());
+
+            std::sort(
+                files.begin(),
+                files.end(),
+                [](const std::pair<std::string, asf::uint64>& lhs, const std::pair<std::string, asf::uint64>& rhs)
+                {
+                    return lhs.second > rhs.second;
+                });
+
+            RENDERER_LOG_INFO(
+                "%s texture file%s read by OSL shaders through OpenImageIO, %s at full resolution sharing a %s cache.",
+                asf::pretty_uint(files.size()).c_str(),
+                files.size() > 1 ? "s" : "",
+                asf::pretty_size(get_total_bytes(report.m_osl_texture_files)).c_str(),
+                asf::pretty_size(report.m_osl_texture_cache_budget).c_str());
+
+            const size_t logged_files = std::min(files.size(), MaxLoggedEntries);
+            for (size_t i = 0; i < logged_files; ++i)
+            {
+                RENDERER_LOG_INFO(
+                    "  %2s. %s: %s",
+                    asf::pretty_uint(i + 1).c_str(),
+                    files[i].first.c_str(),
+                    files[i].second > 0 ? asf::pretty_size(files[i].second).c_str() : "unknown size");
+            }
+        }
+
+        if (report.m_working_set > 0)
+        {
+            RENDERER_LOG_INFO(
+                "process working set: %s (peak %s).",
+                asf::pretty_size(report.m_working_set).c_str(),
+                asf::pretty_size(report.m_peak_working_set).c_str());
+        }
+
+        const size_t logged_entries = std::min(report.m_entries.size(), MaxLoggedEntries);
+        for (size_t i = 0; i < logged_entries; ++i)
+        {
+            const MemoryEntry& entry = report.m_entries[i];
+            RENDERER_LOG_INFO(
+                "  %2s. %s \"%s\": %s (%s)",
+                asf::pretty_uint(i + 1).c_str(),
+                entry.m_category,
+                entry.m_name.c_str(),
+                asf::pretty_size(entry.m_bytes).c_str(),
+                format_parts(entry).c_str());
+        }
+    }
+
+    void write_json_file(const MemoryReport& report, const char* stage, const std::string& filepath)
+    {
+        json::StringBuffer buffer;
+        json::PrettyWriter<json::StringBuffer> writer(buffer);
+
+        writer.StartObject();
+
+        writer.Key("stage");
+        writer.String(stage);
+
+        writer.Key("total_bytes");
+        writer.Uint64(get_total_bytes(report, nullptr));
+
+        writer.Key("entries");
+        writer.StartArray();
+        for (const MemoryEntry& entry : report.m_entries)
+        {
+            writer.StartObject();
+            writer.Key("category");
+            writer.String(entry.m_category);
+            writer.Key("name");
+            writer.String(entry.m_name.c_str());
+            writer.Key("bytes");
+            writer.Uint64(entry.m_bytes);
+            for (const auto& part : entry.m_parts)
+            {
+                writer.Key(part.first);
+                writer.Uint64(part.second);
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        writer.Key("shader_groups");
+        writer.StartArray();
+        for (const ShaderGroupEntry& entry : report.m_shader_groups)
+        {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(entry.m_name.c_str());
+            writer.Key("shaders");
+            writer.Uint64(entry.m_shader_count);
+            writer.Key("connections");
+            writer.Uint64(entry.m_connection_count);
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        writer.Key("texture_cache");
+        writer.StartObject();
+        writer.Key("files");
+        writer.Uint64(report.m_cached_texture_files.size());
+        writer.Key("full_resolution_bytes");
+        writer.Uint64(get_total_bytes(report.m_cached_texture_files));
+        writer.Key("budget_bytes");
+        writer.Uint64(report.m_texture_cache_budget);
+        writer.EndObject();
+
+        writer.Key("osl_texture_cache_budget_bytes");
+        writer.Uint64(report.m_osl_texture_cache_budget);
+
+        if (report.m_has_osl_texture_statistics)
+        {
+            const TextureSystemStatistics& statistics = report.m_osl_texture_statistics;
+            writer.Key("osl_texture_cache_statistics");
+            writer.StartObject();
+            writer.Key("tile_lookups");
+            writer.Uint64(statistics.m_tile_lookups);
+            writer.Key("tile_hits");
+            writer.Uint64(statistics.m_tile_hits);
+            writer.Key("bytes_read");
+            writer.Uint64(statistics.m_bytes_read);
+            writer.Key("files_opened");
+            writer.Uint64(statistics.m_files_opened);
+            writer.Key("file_io_time");
+            writer.Double(statistics.m_fileio_time);
+            writer.EndObject();
+        }
+
+        writer.Key("osl_textures");
+        writer.StartArray();
+        for (const auto& file : report.m_osl_texture_files)
+        {
+            writer.StartObject();
+            writer.Key("filename");
+            writer.String(file.first.c_str());
+            writer.Key("bytes");
+            writer.Uint64(file.second);
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        writer.Key("process");
+        writer.StartObject();
+        writer.Key("working_set_bytes");
+        writer.Uint64(report.m_working_set);
+        writer.Key("peak_working_set_bytes");
+        writer.Uint64(report.m_peak_working_set);
+        writer.EndObject();
+
+        writer.EndObject();
+
+        std::ofstream file(utf8_to_wide(filepath).c_str());
+        file << buffer.GetString();
+
+        if (file)
+            RENDERER_LOG_INFO("wrote memory report to %s.", filepath.c_str());
+        else RENDERER_LOG_ERROR("failed to write memory report to %s.", filepath.c_str());
+    }
+
+    std::string get_json_report_path(const char* stage)
+    {
+        std::string filename = std::string("appleseed-memory-report-") + stage + ".json";
+        std::replace(filename.begin(), filename.end(), ' ', '-');
+
+        std::string filepath = wide_to_utf8(GetCOREInterface()->GetDir(APP_TEMP_DIR));
+        filepath += "\\";
+        filepath += filename;
+
+        return filepath;
+    }
+}
+
+void report_memory_usage(
+    asr::Project&                       project,
+    const RendererSettings&             settings,
+    const char*                         stage,
+    const bool                          write_json_report,
+    const TextureSystemStatistics*      texture_statistics)
+{
+    asr::Scene* scene = project.get_scene();
+    if (scene == nullptr)
+        return;
+
+    MemoryReport report;
+
+    collect_base_group(*scene, std::string(), report);
+
+    for (asr::Assembly& assembly : scene->assemblies())
+        collect_assembly(assembly, std::string(), report);
+
+    std::sort(
+        report.m_entries.begin(),
+        report.m_entries.end(),
+        [](const MemoryEntry& lhs, const MemoryEntry& rhs)
+        {
+            return lhs.m_bytes > rhs.m_bytes;
+        });
+
+    report.m_texture_cache_budget = settings.m_texture_cache_size * 1024 * 1024;
+    report.m_osl_texture_cache_budget = settings.m_osl_texture_cache_size * 1024 * 1024;
+
+    if (texture_statistics != nullptr)
+    {
+        report.m_has_osl_texture_statistics = true;
+        report.m_osl_texture_statistics = *texture_statistics;
+    }
+
+    collect_process_memory(report);
+
+    log_report(report, stage);
+
+    if (write_json_report)
+        write_json_file(report, stage, get_json_report_path(stage));
+}
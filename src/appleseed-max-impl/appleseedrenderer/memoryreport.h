@@ -0,0 +1,48 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// Forward declarations.
+namespace renderer  { class Project; }
+class RendererSettings;
+struct TextureSystemStatistics;
+
+// Log the entities of a project that use the most memory (meshes, baked images,
+// shader groups, texture caches and textures read by OSL shaders), and optionally
+// write the full breakdown to a JSON file in the 3ds Max temporary directory.
+// `stage` identifies the point at which the report was taken, e.g. "project build"
+// or "rendering". Texture files are compared with the cache sizes of `settings`.
+// When `texture_statistics` is provided, the OSL texture cache statistics of the
+// render are included as well.
+void report_memory_usage(
+    renderer::Project&                  project,
+    const RendererSettings&             settings,
+    const char*                         stage,
+    const bool                          write_json_report,
+    const TextureSystemStatistics*      texture_statistics = nullptr);
@@ -0,0 +1,466 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "meshcache.h"
+
+// appleseed-max headers.
+#include "appleseedrenderer/mappedfile.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/platform/windows.h"    // include before 3ds Max headers
+#include "foundation/utility/siphash.h"
+#include "foundation/utility/string.h"
+
+// 3ds Max headers.
+#include <maxapi.h>
+#include <mesh.h>
+
+// Standard headers.
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+    //
+    // An entry file is an EntryHeader followed by the vertices, texture coordinates, vertex normals,
+    // triangles and material ID mappings of the mesh object, as arrays of the types below.
+    //
+
+    const char EntryMagic[4] = { 'A', 'S', 'M', 'C' };
+    const asf::uint32 EntryVersion = 1;
+
+    struct EntryHeader
+    {
+        char        m_magic[4];
+        asf::uint32 m_version;
+        asf::uint64 m_key;
+        asf::uint32 m_vertex_count;
+        asf::uint32 m_tex_coords_count;
+        asf::uint32 m_vertex_normal_count;
+        asf::uint32 m_triangle_count;
+        asf::uint32 m_material_slot_count;
+        asf::uint32 m_mtlid_count;
+    };
+
+    struct TriangleRecord
+    {
+        asf::uint32 m_v[3];
+        asf::uint32 m_n[3];
+        asf::uint32 m_a[3];
+        asf::uint32 m_pa;
+    };
+
+    struct MtlIDRecord
+    {
+        asf::uint32 m_mtlid;
+        asf::uint32 m_slot;
+    };
+
+    asf::uint64 get_entry_size(const EntryHeader& header)
+    {
+        return
+            sizeof(EntryHeader) +
+            static_cast<asf::uint64>(header.m_vertex_count) * sizeof(asr::GVector3) +
+            static_cast<asf::uint64>(header.m_tex_coords_count) * sizeof(asr::GVector2) +
+            static_cast<asf::uint64>(header.m_vertex_normal_count) * sizeof(asr::GVector3) +
+            static_cast<asf::uint64>(header.m_triangle_count) * sizeof(TriangleRecord) +
+            static_cast<asf::uint64>(header.m_mtlid_count) * sizeof(MtlIDRecord);
+    }
+
+    // Read `count` consecutive values of type T and pass each of them to `function`.
+    template <typename T, typename Function>
+    bool read_values(
+        MappedFileReader&                       reader,
+        const asf::uint32                       count,
+        const Function&                         function)
+    {
+        const size_t ChunkSize = MappedFileReader::MaxReadSize / sizeof(T);
+
+        for (size_t begin = 0; begin < count; begin += ChunkSize)
+        {
+            const size_t chunk_count = std::min<size_t>(count - begin, ChunkSize);
+            const T* values = static_cast<const T*>(reader.read(chunk_count * sizeof(T)));
+            if (values == nullptr)
+                return false;
+
+            for (size_t i = 0; i < chunk_count; ++i)
+                function(values[i]);
+        }
+
+        return true;
+    }
+
+    asf::auto_release_ptr<asr::MeshObject> read_entry(
+        MappedFileReader&                       reader,
+        const asf::uint64                       key,
+        const char*                             name,
+        std::map<MtlID, asf::uint32>&           mtlid_to_slot)
+    {
+        const void* header_data = reader.read(sizeof(EntryHeader));
+        if (header_data == nullptr)
+            return asf::auto_release_ptr<asr::MeshObject>();
+
+        // Copy the header since the mapped data only lives until the next read.
+        EntryHeader header;
+        std::memcpy(&header, header_data, sizeof(EntryHeader));
+
+        if (std::memcmp(header.m_magic, EntryMagic, sizeof(EntryMagic)) != 0 ||
+            header.m_version != EntryVersion ||
+            header.m_key != key ||
+            get_entry_size(header) != reader.get_size())
+            return asf::auto_release_ptr<asr::MeshObject>();
+
+        asf::auto_release_ptr<asr::MeshObject> object(
+            asr::MeshObjectFactory().create(name, asr::ParamArray()));
+
+        // Material slots are named after their index, as in convert_mesh_object().
+        for (asf::uint32 i = 0; i < header.m_material_slot_count; ++i)
+        {
+            const auto slot_name = "material_slot_" + asf::to_string(i);
+            object->push_material_slot(slot_name.c_str());
+        }
+
+        object->reserve_vertices(header.m_vertex_count);
+        object->reserve_tex_coords(header.m_tex_coords_count);
+        object->reserve_vertex_normals(header.m_vertex_normal_count);
+        object->reserve_triangles(header.m_triangle_count);
+
+        std::map<MtlID, asf::uint32> entry_mtlid_to_slot;
+
+        const bool success =
+            read_values<asr::GVector3>(
+                reader,
+                header.m_vertex_count,
+                [&](const asr::GVector3& v) { object->push_vertex(v); }) &&
+            read_values<asr::GVector2>(
+                reader,
+                header.m_tex_coords_count,
+                [&](const asr::GVector2& uv) { object->push_tex_coords(uv); }) &&
+            read_values<asr::GVector3>(
+                reader,
+                header.m_vertex_normal_count,
+                [&](const asr::GVector3& n) { object->push_vertex_normal(n); }) &&
+            read_values<TriangleRecord>(
+                reader,
+                header.m_triangle_count,
+                [&](const TriangleRecord& t)
+                {
+                    asr::Triangle triangle;
+                    triangle.m_v0 = t.m_v[0];
+                    triangle.m_v1 = t.m_v[1];
+                    triangle.m_v2 = t.m_v[2];
+                    triangle.m_n0 = t.m_n[0];
+                    triangle.m_n1 = t.m_n[1];
+                    triangle.m_n2 = t.m_n[2];
+                    triangle.m_a0 = t.m_a[0];
+                    triangle.m_a1 = t.m_a[1];
+                    triangle.m_a2 = t.m_a[2];
+                    triangle.m_pa = t.m_pa;
+                    object->push_triangle(triangle);
+                }) &&
+            read_values<MtlIDRecord>(
+                reader,
+                header.m_mtlid_count,
+                [&](const MtlIDRecord& r)
+                {
+                    entry_mtlid_to_slot.insert(std::make_pair(static_cast<MtlID>(r.m_mtlid), r.m_slot));
+                });
+
+        if (!success)
+            return asf::auto_release_ptr<asr::MeshObject>();
+
+        mtlid_to_slot.insert(entry_mtlid_to_slot.begin(), entry_mtlid_to_slot.end());
+
+        return object;
+    }
+
+    template <typename T>
+    void write_value(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    asf::uint64 to_uint64(const DWORD high, const DWORD low)
+    {
+        return (static_cast<asf::uint64>(high) << 32) | low;
+    }
+
+    std::wstring get_cache_directory()
+    {
+        std::wstring directory = GetCOREInterface()->GetDir(APP_TEMP_DIR);
+        directory += L"\\appleseed-mesh-cache";
+        CreateDirectoryW(directory.c_str(), nullptr);
+        return directory;
+    }
+}
+
+MeshCache::MeshCache(const asf::uint64 max_size)
+  : m_max_size(max_size)
+  , m_directory(get_cache_directory())
+  , m_hit_count(0)
+  , m_miss_count(0)
+  , m_loaded_bytes(0)
+  , m_stored_bytes(0)
+{
+}
+
+asf::uint64 MeshCache::compute_key(
+    Mesh&                                       mesh,
+    const Matrix3&                              mesh_transform)
+{
+    const auto hash = [](const void* data, const size_t size)
+    {
+        return size > 0 ? asf::siphash24(data, size) : 0;
+    };
+
+    // Only hash the face members that conversion depends on: Face::flags also holds
+    // selection and scratch bits that don't affect the result.
+    std::vector<asf::uint32> faces;
+    faces.reserve(mesh.getNumFaces() * 5);
+    for (int i = 0, e = mesh.getNumFaces(); i < e; ++i)
+    {
+        const Face& face = mesh.faces[i];
+        faces.push_back(face.v[0]);
+        faces.push_back(face.v[1]);
+        faces.push_back(face.v[2]);
+        faces.push_back(face.getSmGroup());
+        faces.push_back(face.getMatID());
+    }
+
+    float transform[12];
+    for (int i = 0; i < 4; ++i)
+    {
+        const Point3 row = mesh_transform.GetRow(i);
+        transform[i * 3 + 0] = row.x;
+        transform[i * 3 + 1] = row.y;
+        transform[i * 3 + 2] = row.z;
+    }
+
+    const asf::uint64 hashes[] =
+    {
+        EntryVersion,
+        static_cast<asf::uint64>(mesh.getNumVerts()),
+        static_cast<asf::uint64>(mesh.getNumFaces()),
+        static_cast<asf::uint64>(mesh.getNumTVerts()),
+        hash(mesh.verts, mesh.getNumVerts() * sizeof(Point3)),
+        hash(faces.data(), faces.size() * sizeof(asf::uint32)),
+        hash(mesh.tVerts, mesh.getNumTVerts() * sizeof(UVVert)),
+        hash(mesh.tvFace, mesh.getNumTVerts() > 0 ? mesh.getNumFaces() * sizeof(TVFace) : 0),
+        hash(transform, sizeof(transform))
+    };
+
+    return asf::siphash24(hashes, sizeof(hashes));
+}
+
+asf::auto_release_ptr<asr::MeshObject> MeshCache::load(
+    const asf::uint64                           key,
+    const char*                                 name,
+    std::map<MtlID, asf::uint32>&               mtlid_to_slot)
+{
+    asf::auto_release_ptr<asr::MeshObject> object;
+
+    MappedFileReader reader(get_entry_path(key).c_str());
+    if (reader.is_open())
+        object = read_entry(reader, key, name, mtlid_to_slot);
+
+    if (object.get() != nullptr)
+    {
+        // Eviction relies on last access times, which NTFS doesn't always maintain by itself.
+        reader.touch();
+
+        ++m_hit_count;
+        m_loaded_bytes += reader.get_size();
+    }
+    else
+    {
+        // Missing and invalid entries are replaced when the converted mesh is stored.
+        ++m_miss_count;
+    }
+
+    return object;
+}
+
+void MeshCache::store(
+    const asf::uint64                           key,
+    const asr::MeshObject&                      object,
+    const std::map<MtlID, asf::uint32>&         mtlid_to_slot)
+{
+    EntryHeader header;
+    std::memcpy(header.m_magic, EntryMagic, sizeof(EntryMagic));
+    header.m_version = EntryVersion;
+    header.m_key = key;
+    header.m_vertex_count = static_cast<asf::uint32>(object.get_vertex_count());
+    header.m_tex_coords_count = static_cast<asf::uint32>(object.get_tex_coords_count());
+    header.m_vertex_normal_count = static_cast<asf::uint32>(object.get_vertex_normal_count());
+    header.m_triangle_count = static_cast<asf::uint32>(object.get_triangle_count());
+    header.m_material_slot_count = static_cast<asf::uint32>(object.get_material_slot_count());
+    header.m_mtlid_count = static_cast<asf::uint32>(mtlid_to_slot.size());
+
+    // Write to a temporary file first so that other sessions never map a partial entry.
+    const std::wstring path = get_entry_path(key);
+    const std::wstring temp_path = path + L"." + std::to_wstring(GetCurrentProcessId()) + L".tmp";
+
+    {
+        std::ofstream file(temp_path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file)
+            return;
+
+        write_value(file, header);
+
+        for (size_t i = 0, e = object.get_vertex_count(); i < e; ++i)
+            write_value(file, object.get_vertex(i));
+
+        for (size_t i = 0, e = object.get_tex_coords_count(); i < e; ++i)
+            write_value(file, object.get_tex_coords(i));
+
+        for (size_t i = 0, e = object.get_vertex_normal_count(); i < e; ++i)
+            write_value(file, object.get_vertex_normal(i));
+
+        for (size_t i = 0, e = object.get_triangle_count(); i < e; ++i)
+        {
+            const asr::Triangle& triangle = object.get_triangle(i);
+            const TriangleRecord record =
+            {
+                { triangle.m_v0, triangle.m_v1, triangle.m_v2 },
+                { triangle.m_n0, triangle.m_n1, triangle.m_n2 },
+                { triangle.m_a0, triangle.m_a1, triangle.m_a2 },
+                triangle.m_pa
+            };
+            write_value(file, record);
+        }
+
+        for (const auto& entry : mtlid_to_slot)
+        {
+            const MtlIDRecord record = { entry.first, entry.second };
+            write_value(file, record);
+        }
+
+        if (!file)
+        {
+            file.close();
+            DeleteFileW(temp_path.c_str());
+            return;
+        }
+    }
+
+    if (MoveFileExW(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+        m_stored_bytes += get_entry_size(header);
+    else DeleteFileW(temp_path.c_str());
+}
+
+void MeshCache::trim()
+{
+    struct Entry
+    {
+        std::wstring    m_path;
+        asf::uint64     m_size;
+        asf::uint64     m_last_access_time;
+    };
+
+    std::vector<Entry> entries;
+    asf::uint64 total_size = 0;
+
+    WIN32_FIND_DATAW find_data;
+    HANDLE find = FindFirstFileW((m_directory + L"\\*.mesh").c_str(), &find_data);
+    if (find != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            Entry entry;
+            entry.m_path = m_directory + L"\\" + find_data.cFileName;
+            entry.m_size = to_uint64(find_data.nFileSizeHigh, find_data.nFileSizeLow);
+            entry.m_last_access_time =
+                to_uint64(find_data.ftLastAccessTime.dwHighDateTime, find_data.ftLastAccessTime.dwLowDateTime);
+            total_size += entry.m_size;
+            entries.push_back(entry);
+        } while (FindNextFileW(find, &find_data));
+
+        FindClose(find);
+    }
+
+    // Evict least recently used entries first.
+    std::sort(
+        entries.begin(),
+        entries.end(),
+        [](const Entry& lhs, const Entry& rhs)
+        {
+            return lhs.m_last_access_time < rhs.m_last_access_time;
+        });
+
+    size_t entry_count = entries.size();
+    size_t evicted_count = 0;
+    asf::uint64 evicted_bytes = 0;
+
+    for (const auto& entry : entries)
+    {
+        if (total_size <= m_max_size)
+            break;
+
+        if (DeleteFileW(entry.m_path.c_str()))
+        {
+            total_size -= entry.m_size;
+            evicted_bytes += entry.m_size;
+            ++evicted_count;
+            --entry_count;
+        }
+    }
+
+    RENDERER_LOG_INFO(
+        "mesh cache: %s hit%s (%s loaded), %s miss%s (%s stored).",
+        asf::pretty_uint(m_hit_count).c_str(),
+        m_hit_count > 1 ? "s" : "",
+        asf::pretty_size(m_loaded_bytes).c_str(),
+        asf::pretty_uint(m_miss_count).c_str(),
+        m_miss_count > 1 ? "es" : "",
+        asf::pretty_size(m_stored_bytes).c_str());
+
+    RENDERER_LOG_INFO(
+        "mesh cache: %s entr%s using %s out of %s, %s entr%s (%s) evicted.",
+        asf::pretty_uint(entry_count).c_str(),
+        entry_count > 1 ? "ies" : "y",
+        asf::pretty_size(total_size).c_str(),
+        asf::pretty_size(m_max_size).c_str(),
+        asf::pretty_uint(evicted_count).c_str(),
+        evicted_count > 1 ? "ies" : "y",
+        asf::pretty_size(evicted_bytes).c_str());
+}
+
+std::wstring MeshCache::get_entry_path(const asf::uint64 key) const
+{
+    return m_directory + L"\\" + std::to_wstring(key) + L".mesh";
+}
@@ -0,0 +1,95 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// appleseed.renderer headers.
+#include "renderer/api/object.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+
+// 3ds Max headers.
+#include <maxtypes.h>
+
+// Standard headers.
+#include <cstddef>
+#include <map>
+#include <string>
+
+// Forward declarations.
+class Matrix3;
+class Mesh;
+
+//
+// On-disk cache of converted meshes, kept in the 3ds Max temporary directory so that it
+// survives across sessions. Entries are keyed on a hash of the evaluated 3ds Max mesh and
+// of its transform, stored in a compact binary format and memory-mapped when loaded.
+// Least recently used entries are evicted when the cache grows beyond its size limit.
+//
+
+class MeshCache
+  : public foundation::NonCopyable
+{
+  public:
+    // `max_size` is the total size in bytes of the cache files above which entries are evicted.
+    explicit MeshCache(const foundation::uint64 max_size);
+
+    // Compute the key of a 3ds Max mesh converted with a given transform.
+    static foundation::uint64 compute_key(
+        Mesh&                                       mesh,
+        const Matrix3&                              mesh_transform);
+
+    // Create a mesh object from the entry with a given key, or return an empty pointer if there is
+    // no valid entry. The material slots of 3ds Max material IDs are inserted into `mtlid_to_slot`.
+    foundation::auto_release_ptr<renderer::MeshObject> load(
+        const foundation::uint64                    key,
+        const char*                                 name,
+        std::map<MtlID, foundation::uint32>&        mtlid_to_slot);
+
+    // Store a freshly converted mesh object under a given key.
+    void store(
+        const foundation::uint64                    key,
+        const renderer::MeshObject&                 object,
+        const std::map<MtlID, foundation::uint32>&  mtlid_to_slot);
+
+    // Evict least recently used entries beyond the size limit and log cache statistics.
+    void trim();
+
+  private:
+    const foundation::uint64                        m_max_size;
+    const std::wstring                              m_directory;
+    size_t                                          m_hit_count;
+    size_t                                          m_miss_count;
+    foundation::uint64                              m_loaded_bytes;
+    foundation::uint64                              m_stored_bytes;
+
+    std::wstring get_entry_path(const foundation::uint64 key) const;
+};
@@ -0,0 +1,467 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "meshsubdivision.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+    //
+    // Loop subdivision operates on a triangle soup whose corners reference three independent
+    // index spaces: positions, normals and texture coordinates. Positions are smoothed using
+    // Loop's rules; normals and texture coordinates are split at edge midpoints, and normals
+    // are recomputed from the smoothed surface once subdivision is done.
+    //
+
+    struct Triangle
+    {
+        asf::uint32 m_v[3];
+        asf::uint32 m_n[3];
+        asf::uint32 m_a[3];
+        asf::uint32 m_pa;
+    };
+
+    struct Mesh
+    {
+        std::vector<asr::GVector3>  m_vertices;
+        std::vector<asr::GVector3>  m_normals;
+        std::vector<asr::GVector2>  m_tex_coords;
+        std::vector<Triangle>       m_triangles;
+    };
+
+    asf::uint64 make_edge_key(const asf::uint32 a, const asf::uint32 b)
+    {
+        return a < b
+            ? (static_cast<asf::uint64>(a) << 32) | b
+            : (static_cast<asf::uint64>(b) << 32) | a;
+    }
+
+    template <typename Function>
+    void parallel_for(const size_t count, const Function& function)
+    {
+        const size_t MinItemsPerThread = 16 * 1024;
+        const size_t thread_count =
+            std::max<size_t>(
+                1,
+                std::min<size_t>(std::thread::hardware_concurrency(), count / MinItemsPerThread));
+
+        if (thread_count == 1)
+        {
+            function(0, count);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count);
+
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            const size_t begin = count * i / thread_count;
+            const size_t end = count * (i + 1) / thread_count;
+            threads.emplace_back([&function, begin, end]() { function(begin, end); });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    struct Edge
+    {
+        asf::uint32 m_v0, m_v1;             // endpoints
+        asf::uint32 m_opposite[2];          // vertices opposite to the edge in the first two adjacent triangles
+        size_t      m_triangle_count;
+    };
+
+    // Split normals or texture coordinates: each edge receives the midpoint of its endpoints.
+    template <typename Vector>
+    void split_attributes(
+        std::vector<Vector>&            attributes,
+        const std::vector<Triangle>&    triangles,
+        asf::uint32 (Triangle::*        corners)[3],
+        const bool                      normalize,
+        std::vector<asf::uint32>&       midpoints)
+    {
+        std::unordered_map<asf::uint64, asf::uint32> edge_to_midpoint;
+        edge_to_midpoint.reserve(triangles.size() * 2);
+
+        midpoints.resize(triangles.size() * 3);
+
+        for (size_t i = 0, e = triangles.size(); i < e; ++i)
+        {
+            const asf::uint32* indices = triangles[i].*corners;
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                const asf::uint32 a = indices[j];
+                const asf::uint32 b = indices[(j + 1) % 3];
+
+                if (a == asr::Triangle::None || b == asr::Triangle::None)
+                {
+                    midpoints[i * 3 + j] = asr::Triangle::None;
+                    continue;
+                }
+
+                const auto result =
+                    edge_to_midpoint.insert(
+                        std::make_pair(make_edge_key(a, b), static_cast<asf::uint32>(attributes.size())));
+
+                if (result.second)
+                {
+                    const Vector midpoint = (attributes[a] + attributes[b]) * 0.5f;
+                    attributes.push_back(normalize ? asf::safe_normalize(midpoint) : midpoint);
+                }
+
+                midpoints[i * 3 + j] = result.first->second;
+            }
+        }
+    }
+
+    void subdivide(Mesh& mesh)
+    {
+        const std::vector<asr::GVector3>& vertices = mesh.m_vertices;
+        const std::vector<Triangle>& triangles = mesh.m_triangles;
+
+        // Collect edges and their adjacency.
+        std::vector<Edge> edges;
+        std::unordered_map<asf::uint64, asf::uint32> edge_indices;
+        edges.reserve(triangles.size() * 3 / 2);
+        edge_indices.reserve(triangles.size() * 2);
+
+        std::vector<asf::uint32> triangle_edges(triangles.size() * 3);
+
+        for (size_t i = 0, e = triangles.size(); i < e; ++i)
+        {
+            const Triangle& triangle = triangles[i];
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                const asf::uint32 a = triangle.m_v[j];
+                const asf::uint32 b = triangle.m_v[(j + 1) % 3];
+                const asf::uint32 c = triangle.m_v[(j + 2) % 3];
+
+                const auto result =
+                    edge_indices.insert(
+                        std::make_pair(make_edge_key(a, b), static_cast<asf::uint32>(edges.size())));
+
+                if (result.second)
+                {
+                    Edge edge;
+                    edge.m_v0 = a;
+                    edge.m_v1 = b;
+                    edge.m_opposite[0] = c;
+                    edge.m_triangle_count = 1;
+                    edges.push_back(edge);
+                }
+                else
+                {
+                    Edge& edge = edges[result.first->second];
+                    if (edge.m_triangle_count == 1)
+                        edge.m_opposite[1] = c;
+                    ++edge.m_triangle_count;
+                }
+
+                triangle_edges[i * 3 + j] = result.first->second;
+            }
+        }
+
+        // Accumulate neighbors of each vertex. Edges shared by other than two triangles
+        // are treated as creases so that open and non-manifold meshes keep their borders.
+        const size_t vertex_count = vertices.size();
+        std::vector<asr::GVector3> neighbor_sums(vertex_count, asr::GVector3(0.0f));
+        std::vector<asr::GVector3> crease_sums(vertex_count, asr::GVector3(0.0f));
+        std::vector<asf::uint32> valences(vertex_count, 0);
+        std::vector<asf::uint32> crease_valences(vertex_count, 0);
+
+        for (const Edge& edge : edges)
+        {
+            neighbor_sums[edge.m_v0] += vertices[edge.m_v1];
+            neighbor_sums[edge.m_v1] += vertices[edge.m_v0];
+            ++valences[edge.m_v0];
+            ++valences[edge.m_v1];
+
+            if (edge.m_triangle_count != 2)
+            {
+                crease_sums[edge.m_v0] += vertices[edge.m_v1];
+                crease_sums[edge.m_v1] += vertices[edge.m_v0];
+                ++crease_valences[edge.m_v0];
+                ++crease_valences[edge.m_v1];
+            }
+        }
+
+        // Compute the new positions: even vertices first, then one odd vertex per edge.
+        std::vector<asr::GVector3> new_vertices(vertex_count + edges.size());
+
+        parallel_for(vertex_count, [&](const size_t begin, const size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const asr::GVector3& v = vertices[i];
+
+                if (crease_valences[i] == 2)
+                    new_vertices[i] = v * 0.75f + crease_sums[i] * 0.125f;
+                else if (crease_valences[i] > 0 || valences[i] < 3)
+                    new_vertices[i] = v;    // corner
+                else
+                {
+                    const float n = static_cast<float>(valences[i]);
+                    const float beta = valences[i] == 3 ? 3.0f / 16.0f : 3.0f / (8.0f * n);
+                    new_vertices[i] = v * (1.0f - n * beta) + neighbor_sums[i] * beta;
+                }
+            }
+        });
+
+        parallel_for(edges.size(), [&](const size_t begin, const size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Edge& edge = edges[i];
+                const asr::GVector3& a = vertices[edge.m_v0];
+                const asr::GVector3& b = vertices[edge.m_v1];
+
+                new_vertices[vertex_count + i] =
+                    edge.m_triangle_count == 2
+                        ? (a + b) * 0.375f + (vertices[edge.m_opposite[0]] + vertices[edge.m_opposite[1]]) * 0.125f
+                        : (a + b) * 0.5f;
+            }
+        });
+
+        // Split normals and texture coordinates.
+        std::vector<asf::uint32> normal_midpoints, tex_coords_midpoints;
+        split_attributes(mesh.m_normals, triangles, &Triangle::m_n, true, normal_midpoints);
+        split_attributes(mesh.m_tex_coords, triangles, &Triangle::m_a, false, tex_coords_midpoints);
+
+        // Replace each triangle by four triangles.
+        std::vector<Triangle> new_triangles(triangles.size() * 4);
+
+        parallel_for(triangles.size(), [&](const size_t begin, const size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Triangle& t = triangles[i];
+
+                const asf::uint32 v[6] =
+                {
+                    t.m_v[0], t.m_v[1], t.m_v[2],
+                    static_cast<asf::uint32>(vertex_count) + triangle_edges[i * 3 + 0],
+                    static_cast<asf::uint32>(vertex_count) + triangle_edges[i * 3 + 1],
+                    static_cast<asf::uint32>(vertex_count) + triangle_edges[i * 3 + 2]
+                };
+
+                const asf::uint32 n[6] =
+                {
+                    t.m_n[0], t.m_n[1], t.m_n[2],
+                    normal_midpoints[i * 3 + 0], normal_midpoints[i * 3 + 1], normal_midpoints[i * 3 + 2]
+                };
+
+                const asf::uint32 a[6] =
+                {
+                    t.m_a[0], t.m_a[1], t.m_a[2],
+                    tex_coords_midpoints[i * 3 + 0], tex_coords_midpoints[i * 3 + 1], tex_coords_midpoints[i * 3 + 2]
+                };
+
+                // Corners of the four child triangles, as indices into the arrays above.
+                static const size_t Children[4][3] =
+                {
+                    { 0, 3, 5 },
+                    { 3, 1, 4 },
+                    { 5, 4, 2 },
+                    { 3, 4, 5 }
+                };
+
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    Triangle& child = new_triangles[i * 4 + c];
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        child.m_v[k] = v[Children[c][k]];
+                        child.m_n[k] = n[Children[c][k]];
+                        child.m_a[k] = a[Children[c][k]];
+                    }
+                    child.m_pa = t.m_pa;
+                }
+            }
+        });
+
+        mesh.m_vertices.swap(new_vertices);
+        mesh.m_triangles.swap(new_triangles);
+    }
+
+    // Set each normal to the area-weighted average of the normals of the triangles that reference it.
+    // Corners that share a normal index stay smooth while hard edges, which use distinct normal indices
+    // on either side, are preserved.
+    void compute_normals(Mesh& mesh)
+    {
+        const std::vector<asr::GVector3>& vertices = mesh.m_vertices;
+        std::vector<asr::GVector3> sums(mesh.m_normals.size(), asr::GVector3(0.0f));
+
+        for (const Triangle& t : mesh.m_triangles)
+        {
+            const asr::GVector3& v0 = vertices[t.m_v[0]];
+            const asr::GVector3& v1 = vertices[t.m_v[1]];
+            const asr::GVector3& v2 = vertices[t.m_v[2]];
+
+            // The length of the cross product is twice the area of the triangle.
+            const asr::GVector3 triangle_normal = asf::cross(v1 - v0, v2 - v0);
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                if (t.m_n[k] != asr::Triangle::None)
+                    sums[t.m_n[k]] += triangle_normal;
+            }
+        }
+
+        for (size_t i = 0, e = sums.size(); i < e; ++i)
+        {
+            if (asf::square_norm(sums[i]) > 0.0f)
+                mesh.m_normals[i] = asf::normalize(sums[i]);
+        }
+    }
+}
+
+asf::auto_release_ptr<asr::MeshObject> subdivide_mesh_object(
+    const asr::MeshObject&      object,
+    const size_t                levels)
+{
+    // Extract the mesh.
+    Mesh mesh;
+
+    mesh.m_vertices.reserve(object.get_vertex_count());
+    for (size_t i = 0, e = object.get_vertex_count(); i < e; ++i)
+        mesh.m_vertices.push_back(object.get_vertex(i));
+
+    mesh.m_normals.reserve(object.get_vertex_normal_count());
+    for (size_t i = 0, e = object.get_vertex_normal_count(); i < e; ++i)
+        mesh.m_normals.push_back(object.get_vertex_normal(i));
+
+    mesh.m_tex_coords.reserve(object.get_tex_coords_count());
+    for (size_t i = 0, e = object.get_tex_coords_count(); i < e; ++i)
+        mesh.m_tex_coords.push_back(object.get_tex_coords(i));
+
+    mesh.m_triangles.reserve(object.get_triangle_count());
+    for (size_t i = 0, e = object.get_triangle_count(); i < e; ++i)
+    {
+        const asr::Triangle& source = object.get_triangle(i);
+
+        Triangle triangle;
+        triangle.m_v[0] = source.m_v0;
+        triangle.m_v[1] = source.m_v1;
+        triangle.m_v[2] = source.m_v2;
+        triangle.m_n[0] = source.m_n0;
+        triangle.m_n[1] = source.m_n1;
+        triangle.m_n[2] = source.m_n2;
+        triangle.m_a[0] = source.m_a0;
+        triangle.m_a[1] = source.m_a1;
+        triangle.m_a[2] = source.m_a2;
+        triangle.m_pa = source.m_pa;
+        mesh.m_triangles.push_back(triangle);
+    }
+
+    // Subdivide.
+    for (size_t i = 0; i < levels; ++i)
+        subdivide(mesh);
+
+    if (levels > 0)
+        compute_normals(mesh);
+
+    // Build the resulting mesh object.
+    asf::auto_release_ptr<asr::MeshObject> result(
+        asr::MeshObjectFactory().create(object.get_name(), object.get_parameters()));
+
+    for (size_t i = 0, e = object.get_material_slot_count(); i < e; ++i)
+        result->push_material_slot(object.get_material_slot(i));
+
+    result->reserve_vertices(mesh.m_vertices.size());
+    for (const auto& v : mesh.m_vertices)
+        result->push_vertex(v);
+
+    result->reserve_vertex_normals(mesh.m_normals.size());
+    for (const auto& n : mesh.m_normals)
+        result->push_vertex_normal(n);
+
+    result->reserve_tex_coords(mesh.m_tex_coords.size());
+    for (const auto& uv : mesh.m_tex_coords)
+        result->push_tex_coords(uv);
+
+    result->reserve_triangles(mesh.m_triangles.size());
+    for (const auto& t : mesh.m_triangles)
+    {
+        asr::Triangle triangle;
+        triangle.m_v0 = t.m_v[0];
+        triangle.m_v1 = t.m_v[1];
+        triangle.m_v2 = t.m_v[2];
+        triangle.m_n0 = t.m_n[0];
+        triangle.m_n1 = t.m_n[1];
+        triangle.m_n2 = t.m_n[2];
+        triangle.m_a0 = t.m_a[0];
+        triangle.m_a1 = t.m_a[1];
+        triangle.m_a2 = t.m_a[2];
+        triangle.m_pa = t.m_pa;
+        result->push_triangle(triangle);
+    }
+
+    return result;
+}
+
+float compute_average_edge_length(const asr::MeshObject& object)
+{
+    const size_t triangle_count = object.get_triangle_count();
+    if (triangle_count == 0)
+        return 0.0f;
+
+    // Sample at most a few thousand triangles, this is only used to pick a subdivision level.
+    const size_t MaxSampledTriangles = 4096;
+    const size_t step = std::max<size_t>(1, triangle_count / MaxSampledTriangles);
+
+    double total_length = 0.0;
+    size_t edge_count = 0;
+
+    for (size_t i = 0; i < triangle_count; i += step)
+    {
+        const asr::Triangle& triangle = object.get_triangle(i);
+        const asr::GVector3& v0 = object.get_vertex(triangle.m_v0);
+        const asr::GVector3& v1 = object.get_vertex(triangle.m_v1);
+        const asr::GVector3& v2 = object.get_vertex(triangle.m_v2);
+        total_length += asf::norm(v1 - v0) + asf::norm(v2 - v1) + asf::norm(v0 - v2);
+        edge_count += 3;
+    }
+
+    return static_cast<float>(total_length / edge_count);
+}
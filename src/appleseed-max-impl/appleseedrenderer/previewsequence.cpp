@@ -0,0 +1,245 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "previewsequence.h"
+
+// appleseed-max headers.
+#include "appleseedrenderer/renderersettings.h"
+#include "appleseedrenderer/tilecallback.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/frame.h"
+#include "renderer/api/project.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/atomic.h"
+#include "foundation/platform/types.h"
+
+// 3ds Max headers.
+#include <bitmap.h>
+#include <maxapi.h>
+#include <render.h>
+
+// Standard headers.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+    // Renderer controller shared by all the frames of a batch. Unlike RendererController,
+    // it never calls into 3ds Max since it is polled from the frames' rendering threads.
+    class PreviewBatchController
+      : public asr::DefaultRendererController
+    {
+      public:
+        PreviewBatchController()
+          : m_status(ContinueRendering)
+        {
+        }
+
+        Status get_status() const override
+        {
+            return m_status;
+        }
+
+        void abort()
+        {
+            m_status = AbortRendering;
+        }
+
+      private:
+        std::atomic<Status> m_status;
+    };
+
+    void render_preview_frame(
+        PreviewFrame&                   frame,
+        PreviewBatchController&         controller,
+        volatile asf::uint32*           rendered_tile_count,
+        std::atomic<size_t>&            finished_frame_count)
+    {
+        TileCallback tile_callback(frame.m_bitmap, rendered_tile_count);
+
+        std::unique_ptr<asr::MasterRenderer> renderer(
+            new asr::MasterRenderer(
+                frame.m_project.ref(),
+                frame.m_project->configurations().get_by_name("final")->get_inherited_parameters(),
+                &controller,
+                &tile_callback));
+
+        renderer->render();
+
+        ++finished_frame_count;
+    }
+}
+
+
+//
+// PreviewFrame class implementation.
+//
+
+PreviewFrame::PreviewFrame(
+    const TimeValue                 time,
+    Bitmap*                         bitmap)
+  : m_time(time)
+  , m_bitmap(bitmap)
+  , m_owns_bitmap(false)
+{
+}
+
+PreviewFrame::~PreviewFrame()
+{
+    // Release the project before the bitmap its tile callback wrote to.
+    m_project.reset();
+
+    if (m_owns_bitmap)
+        m_bitmap->DeleteThis();
+}
+
+std::unique_ptr<PreviewFrame> create_offscreen_preview_frame(
+    const TimeValue                 time,
+    Bitmap*                         bitmap)
+{
+    BitmapInfo bitmap_info;
+    bitmap_info.SetWidth(bitmap->Width());
+    bitmap_info.SetHeight(bitmap->Height());
+    bitmap_info.SetType(BMM_FLOAT_RGBA_32);
+    bitmap_info.SetFlags(MAP_HAS_ALPHA);
+
+    std::unique_ptr<PreviewFrame> frame(new PreviewFrame(time, TheManager->Create(&bitmap_info)));
+    frame->m_owns_bitmap = true;
+
+    return frame;
+}
+
+
+//
+// Preview sequence rendering.
+//
+
+bool is_rendering_sequence()
+{
+    // Frame lists are rendered one frame at a time.
+    const int time_type = GetCOREInterface()->GetRendTimeType();
+    return time_type == REND_TIMESEGMENT || time_type == REND_TIMERANGE;
+}
+
+std::vector<TimeValue> get_sequence_frame_times(
+    const TimeValue                 time,
+    const size_t                    max_count)
+{
+    std::vector<TimeValue> times;
+    times.push_back(time);
+
+    if (!is_rendering_sequence())
+        return times;
+
+    Interface* ip = GetCOREInterface();
+
+    const TimeValue end_time =
+        ip->GetRendTimeType() == REND_TIMESEGMENT
+            ? ip->GetAnimRange().End()
+            : ip->GetRendEnd();
+
+    const TimeValue step = GetTicksPerFrame() * std::max(ip->GetRendNThFrame(), 1);
+
+    for (TimeValue t = time + step; t <= end_time && times.size() < max_count; t += step)
+        times.push_back(t);
+
+    return times;
+}
+
+asr::IRendererController::Status render_preview_frames(
+    PreviewFrameVector&             frames,
+    const RendererSettings&         settings,
+    RendProgressCallback*           progress_cb)
+{
+    // At preview resolutions a single master renderer spends much of its time in per-frame
+    // setup and in the last tiles of the frame: split the threads between several frames instead.
+    const size_t thread_count =
+        settings.m_rendering_threads > 0
+            ? static_cast<size_t>(settings.m_rendering_threads)
+            : static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1U));
+    const size_t threads_per_frame = std::max<size_t>(thread_count / frames.size(), 1);
+
+    // Each frame has its own texture store: split the texture cache between them too.
+    const asf::uint64 texture_store_size_per_frame =
+        settings.m_texture_cache_size * 1024 * 1024 / frames.size();
+
+    size_t total_tile_count = 0;
+    for (auto& frame : frames)
+    {
+        frame->m_project->configurations().get_by_name("final")->get_parameters()
+            .insert_path("rendering_threads", threads_per_frame)
+            .insert_path("texture_store.max_size", texture_store_size_per_frame);
+
+        total_tile_count +=
+              static_cast<size_t>(settings.m_passes)
+            * frame->m_project->get_frame()->image().properties().m_tile_count;
+    }
+
+    // Number of rendered tiles across all frames, shared counter accessed atomically.
+    volatile asf::uint32 rendered_tile_count = 0;
+    std::atomic<size_t> finished_frame_count(0);
+    PreviewBatchController controller;
+
+    std::vector<std::thread> threads;
+    for (auto& frame : frames)
+    {
+        threads.push_back(
+            std::thread(
+                render_preview_frame,
+                std::ref(*frame),
+                std::ref(controller),
+                &rendered_tile_count,
+                std::ref(finished_frame_count)));
+    }
+
+    // Report progress to 3ds Max from this thread while the frames are rendering.
+    while (finished_frame_count < frames.size())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        if (progress_cb != nullptr &&
+            progress_cb->Progress(
+                static_cast<int>(asf::atomic_read(&rendered_tile_count)),
+                static_cast<int>(total_tile_count)) != RENDPROG_CONTINUE)
+            controller.abort();
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return controller.get_status();
+}
@@ -0,0 +1,88 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// appleseed.renderer headers.
+#include "renderer/api/rendering.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/windows.h"    // include before 3ds Max headers
+#include "foundation/utility/autoreleaseptr.h"
+
+// 3ds Max headers.
+#include <maxtypes.h>
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Forward declarations.
+namespace renderer  { class Project; }
+class Bitmap;
+class RendererSettings;
+class RendProgressCallback;
+
+// A frame of an animation sequence rendered as part of a preview batch.
+struct PreviewFrame
+{
+    TimeValue                                           m_time;
+    Bitmap*                                             m_bitmap;
+    bool                                                m_owns_bitmap;
+    foundation::auto_release_ptr<renderer::Project>     m_project;
+
+    PreviewFrame(
+        const TimeValue             time,
+        Bitmap*                     bitmap);
+
+    ~PreviewFrame();
+};
+
+// Create a frame rendered to an offscreen bitmap of the same size as `bitmap`.
+std::unique_ptr<PreviewFrame> create_offscreen_preview_frame(
+    const TimeValue                 time,
+    Bitmap*                         bitmap);
+
+typedef std::vector<std::unique_ptr<PreviewFrame>> PreviewFrameVector;
+
+// Return true if 3ds Max is rendering an animation sequence rather than a single frame.
+bool is_rendering_sequence();
+
+// Return the times of the next `max_count` frames of the animation sequence 3ds Max
+// is rendering, starting with `time`. Only `time` is returned for single frames.
+std::vector<TimeValue> get_sequence_frame_times(
+    const TimeValue                 time,
+    const size_t                    max_count);
+
+// Render a batch of frames concurrently. Each frame gets an equal share of the
+// rendering threads and of the texture cache and is written to its own bitmap.
+renderer::IRendererController::Status render_preview_frames(
+    PreviewFrameVector&             frames,
+    const RendererSettings&         settings,
+    RendProgressCallback*           progress_cb);
@@ -34,6 +34,8 @@
 #include "appleseedobjpropsmod/appleseedobjpropsmod.h"
 #include "appleseedrenderelement/appleseedrenderelement.h"
 #include "appleseedrenderer/maxsceneentities.h"
+#include "appleseedrenderer/meshcache.h"
+#include "appleseedrenderer/meshsubdivision.h"
 #include "appleseedrenderer/renderersettings.h"
 #include "iappleseedmtl.h"
 #include "seexprutils.h"
@@ -48,6 +50,7 @@
 #include "renderer/api/environmentshader.h"
 #include "renderer/api/frame.h"
 #include "renderer/api/light.h"
+#include "renderer/api/log.h"
 #include "renderer/api/material.h"
 #include "renderer/api/object.h"
 #include "renderer/api/postprocessing.h"
@@ -68,6 +71,7 @@
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/iostreamop.h"
 #include "foundation/utility/searchpaths.h"
+#include "foundation/utility/string.h"
 
 // 3ds Max headers.
 #include <assert1.h>
@@ -85,9 +89,13 @@
 #include <triobj.h>
 
 // Standard headers.
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <limits>
 #include <map>
+#include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -174,8 +182,25 @@ namespace
     {
         std::string                     m_name;             // name of the appleseed object
         std::map<MtlID, asf::uint32>    m_mtlid_to_slot;    // map a 3ds Max's material ID to an appleseed's material slot
+        std::string                     m_standin_material; // material of all instances of a stand-in, empty for regular objects
     };
 
+    const AppleseedObjPropsMod* find_obj_props_mod(Object* object)
+    {
+        if (object->SuperClassID() == GEN_DERIVOB_CLASS_ID)
+        {
+            IDerivedObject* derived_object = static_cast<IDerivedObject*>(object);
+            for (int i = 0, e = derived_object->NumModifiers(); i < e; ++i)
+            {
+                Modifier* modifier = derived_object->GetModifier(i);
+                if (modifier->ClassID() == AppleseedObjPropsMod::get_class_id())
+                    return static_cast<const AppleseedObjPropsMod*>(modifier);
+            }
+        }
+
+        return nullptr;
+    }
+
     asf::auto_release_ptr<asr::MeshObject> convert_mesh_object(
         Mesh&                   mesh,
         const Matrix3&          mesh_transform,
@@ -315,13 +340,87 @@ namespace
         return object;
     }
 
+    // Convert a mesh, reusing the result of a previous conversion stored in the mesh cache if any.
+    asf::auto_release_ptr<asr::MeshObject> convert_mesh_object(
+        Mesh&                   mesh,
+        const Matrix3&          mesh_transform,
+        ObjectInfo&             object_info,
+        MeshCache*              mesh_cache)
+    {
+        if (mesh_cache == nullptr)
+            return convert_mesh_object(mesh, mesh_transform, object_info);
+
+        const asf::uint64 key = MeshCache::compute_key(mesh, mesh_transform);
+
+        asf::auto_release_ptr<asr::MeshObject> cached_object =
+            mesh_cache->load(key, object_info.m_name.c_str(), object_info.m_mtlid_to_slot);
+        if (cached_object.get() != nullptr)
+            return cached_object;
+
+        asf::auto_release_ptr<asr::MeshObject> object =
+            convert_mesh_object(mesh, mesh_transform, object_info);
+        mesh_cache->store(key, object.ref(), object_info.m_mtlid_to_slot);
+
+        return object;
+    }
+
+    // Tessellate a mesh object so that its edges span about the target length on screen,
+    // as configured in the appleseed Object Properties modifier of the node.
+    asf::auto_release_ptr<asr::MeshObject> apply_render_time_subdivision(
+        asf::auto_release_ptr<asr::MeshObject>  object,
+        INode*                                  object_node,
+        const float                             pixels_per_unit,
+        const TimeValue                         time)
+    {
+        if (pixels_per_unit <= 0.0f)
+            return object;
+
+        const AppleseedObjPropsMod* obj_props_mod = find_obj_props_mod(object_node->GetObjectRef());
+        if (obj_props_mod == nullptr)
+            return object;
+
+        const Matrix3 object_to_world = object_node->GetObjTMAfterWSM(time);
+        const float scale =
+            (Length(object_to_world.GetRow(0)) +
+             Length(object_to_world.GetRow(1)) +
+             Length(object_to_world.GetRow(2))) / 3.0f;
+
+        const float edge_length_in_pixels =
+            compute_average_edge_length(object.ref()) * scale * pixels_per_unit;
+
+        const size_t levels = obj_props_mod->get_subdivision_levels(edge_length_in_pixels, time);
+        if (levels == 0)
+            return object;
+
+        RENDERER_LOG_DEBUG(
+            "subdividing object \"%s\" %s time%s (%s triangles)...",
+            object->get_name(),
+            asf::pretty_uint(levels).c_str(),
+            levels > 1 ? "s" : "",
+            asf::pretty_uint(object->get_triangle_count() << (2 * levels)).c_str());
+
+        return subdivide_mesh_object(object.ref(), levels);
+    }
+
     std::vector<ObjectInfo> create_mesh_objects(
-        asr::Assembly&          assembly,
-        INode*                  object_node,
-        const TimeValue         time)
+        asr::ObjectContainer&           objects,
+        INode*                          object_node,
+        const TimeValue                 time,
+        const float                     pixels_per_unit,
+        MeshCache*                      mesh_cache,
+        const std::vector<std::string>* object_names = nullptr)
     {
         std::vector<ObjectInfo> object_infos;
 
+        // Objects are named after the node unless explicit names are provided (e.g. when rebuilding them).
+        auto make_object_name = [&]()
+        {
+            const size_t index = object_infos.size();
+            return object_names != nullptr && index < object_names->size()
+                ? (*object_names)[index]
+                : make_unique_name(objects, wide_to_utf8(object_node->GetName()));
+        };
+
         // Retrieve the GeomObject at the desired time.
         const ObjectState object_state = object_node->EvalWorldState(time);
         GeomObject* geom_object = static_cast<GeomObject*>(object_state.obj);
@@ -338,16 +437,19 @@ namespace
                 if (mesh != nullptr)
                 {
                     ObjectInfo object_info;
-                    object_info.m_name = wide_to_utf8(object_node->GetName());
-                    object_info.m_name = make_unique_name(assembly.objects(), object_info.m_name);
+                    object_info.m_name = make_object_name();
 
                     Matrix3 mesh_transform;
                     Interval mesh_transform_validity;
                     geom_object->GetMultipleRenderMeshTM(time, object_node, view, i, mesh_transform, mesh_transform_validity);
 
-                    assembly.objects().insert(
+                    objects.insert(
                         asf::auto_release_ptr<asr::Object>(
-                            convert_mesh_object(*mesh, mesh_transform, object_info)));
+                            apply_render_time_subdivision(
+                                convert_mesh_object(*mesh, mesh_transform, object_info, mesh_cache),
+                                object_node,
+                                pixels_per_unit,
+                                time)));
             
                     if (need_delete)
                         mesh->DeleteThis();
@@ -364,12 +466,15 @@ namespace
             if (mesh != nullptr)
             {
                 ObjectInfo object_info;
-                object_info.m_name = wide_to_utf8(object_node->GetName());
-                object_info.m_name = make_unique_name(assembly.objects(), object_info.m_name);
+                object_info.m_name = make_object_name();
 
-                assembly.objects().insert(
+                objects.insert(
                     asf::auto_release_ptr<asr::Object>(
-                        convert_mesh_object(*mesh, Matrix3(TRUE), object_info)));
+                        apply_render_time_subdivision(
+                            convert_mesh_object(*mesh, Matrix3(TRUE), object_info, mesh_cache),
+                            object_node,
+                            pixels_per_unit,
+                            time)));
 
                 if (need_delete)
                     mesh->DeleteThis();
@@ -381,7 +486,85 @@ namespace
         return object_infos;
     }
 
+    // Create a box matching the object space bounding box of a node, oriented by its instances' transforms,
+    // together with a default material of the given color shared by all its instances.
+    std::vector<ObjectInfo> create_standin_objects(
+        asr::Assembly&                  assembly,
+        INode*                          object_node,
+        const Color&                    color,
+        const TimeValue                 time)
+    {
+        std::vector<ObjectInfo> object_infos;
+
+        const ObjectState object_state = object_node->EvalWorldState(time);
+        if (object_state.obj == nullptr)
+            return object_infos;
+
+        Box3 bbox;
+        object_state.obj->GetDeformBBox(time, bbox, nullptr);
+        if (bbox.IsEmpty())
+            return object_infos;
+
+        ObjectInfo object_info;
+        object_info.m_name = make_unique_name(assembly.objects(), wide_to_utf8(object_node->GetName()) + "_standin");
+        object_info.m_mtlid_to_slot.insert(std::make_pair(0, 0));
+        object_info.m_standin_material =
+            insert_default_material(assembly, object_info.m_name + "_mat", to_color3f(color));
+
+        asf::auto_release_ptr<asr::MeshObject> object(
+            asr::MeshObjectFactory().create(object_info.m_name.c_str(), asr::ParamArray()));
+
+        // Corner i of a Box3 uses the maximum x, y and z coordinates when bits 0, 1 and 2 of i are set.
+        for (int i = 0; i < 8; ++i)
+        {
+            const Point3 corner = bbox[i];
+            object->push_vertex(asr::GVector3(corner.x, corner.y, corner.z));
+        }
+
+        // Faces as quads of corners in counterclockwise order seen from outside, with their normals.
+        static const asf::uint32 Faces[6][4] =
+        {
+            { 0, 4, 6, 2 }, { 1, 3, 7, 5 },
+            { 0, 1, 5, 4 }, { 2, 6, 7, 3 },
+            { 0, 2, 3, 1 }, { 4, 5, 7, 6 }
+        };
+
+        static const float Normals[6][3] =
+        {
+            { -1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f },
+            { 0.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+            { 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f }
+        };
+
+        object->push_material_slot("material_slot_0");
+
+        for (int i = 0; i < 6; ++i)
+        {
+            const asf::uint32 n =
+                static_cast<asf::uint32>(
+                    object->push_vertex_normal(asr::GVector3(Normals[i][0], Normals[i][1], Normals[i][2])));
+
+            for (int j = 0; j < 2; ++j)
+            {
+                asr::Triangle triangle;
+                triangle.m_v0 = Faces[i][0];
+                triangle.m_v1 = Faces[i][j + 1];
+                triangle.m_v2 = Faces[i][j + 2];
+                triangle.m_n0 = triangle.m_n1 = triangle.m_n2 = n;
+                triangle.m_a0 = triangle.m_a1 = triangle.m_a2 = asr::Triangle::None;
+                triangle.m_pa = 0;
+                object->push_triangle(triangle);
+            }
+        }
+
+        assembly.objects().insert(asf::auto_release_ptr<asr::Object>(object));
+        object_infos.push_back(object_info);
+
+        return object_infos;
+    }
+
     typedef std::map<Mtl*, std::string> MaterialMap;
+    typedef std::map<Mtl*, float> MaterialFootprintMap;
 
     struct MaterialInfo
     {
@@ -390,12 +573,13 @@ namespace
     };
 
     MaterialInfo get_or_create_material(
-        asr::Assembly&          assembly,
-        const std::string&      instance_name,
-        Mtl*                    mtl,
-        MaterialMap&            material_map,
-        const bool              use_max_procedural_maps,
-        const TimeValue         time)
+        asr::Assembly&                  assembly,
+        const std::string&              instance_name,
+        Mtl*                            mtl,
+        MaterialMap&                    material_map,
+        const MaterialFootprintMap&     material_footprints,
+        const bool                      use_max_procedural_maps,
+        const TimeValue                 time)
     {
         MaterialInfo material_info;
 
@@ -410,6 +594,10 @@ namespace
                 // The appleseed material does not exist yet, let the material plugin create it.
                 material_info.m_name =
                     make_unique_name(assembly.materials(), wide_to_utf8(mtl->GetName()) + "_mat");
+                const auto footprint = material_footprints.find(mtl);
+                TextureFootprintScope footprint_scope(
+                    footprint != material_footprints.end() ? footprint->second : 0.0f,
+                    time);
                 assembly.materials().insert(
                     appleseed_mtl->create_material(
                         assembly,
@@ -512,6 +700,284 @@ namespace
         return false;
     }
 
+    bool is_light_emitting_material(Mtl* mtl)
+    {
+        IAppleseedMtl* appleseed_mtl =
+            static_cast<IAppleseedMtl*>(mtl->GetInterface(IAppleseedMtl::interface_id()));
+        if (appleseed_mtl != nullptr && appleseed_mtl->can_emit_light())
+            return true;
+
+        for (int i = 0, e = mtl->NumSubMtls(); i < e; ++i)
+        {
+            Mtl* sub_mtl = mtl->GetSubMtl(i);
+            if (sub_mtl != nullptr)
+            {
+                if (is_light_emitting_material(sub_mtl))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    struct LODContext
+    {
+        bool                        m_enabled;
+        Point3                      m_camera_position;
+        float                       m_focal_length_in_pixels;   // 0 for non-perspective views
+        std::set<INode*>            m_lod_nodes;                // nodes only rendered as levels of detail of other nodes
+        std::map<Object*, float>    m_shared_distances;         // distance of the nearest instance of objects without per-instance LOD
+        std::map<Object*, float>    m_surface_distances;        // distance to the nearest instance of subdivided objects
+        float                       m_standin_size;             // on-screen size in pixels below which objects are replaced by boxes, 0 to disable
+        std::map<Object*, Color>    m_standin_colors;           // average diffuse color of the instances of objects replaced by boxes
+    };
+
+    float get_camera_distance(INode* node, const LODContext& lod_context, const TimeValue time)
+    {
+        // Use the pivot rather than the bounding box to avoid evaluating the full resolution geometry.
+        return Length(node->GetObjTMAfterWSM(time).GetTrans() - lod_context.m_camera_position);
+    }
+
+    // Return the distance from the camera to the bounding sphere of a node, 0 if the camera is inside.
+    float get_camera_surface_distance(INode* node, const LODContext& lod_context, const TimeValue time)
+    {
+        const ObjectState object_state = node->EvalWorldState(time);
+        if (object_state.obj == nullptr)
+            return 0.0f;
+
+        Matrix3 object_to_world = node->GetObjTMAfterWSM(time);
+        Box3 bbox;
+        object_state.obj->GetDeformBBox(time, bbox, &object_to_world);
+        if (bbox.IsEmpty())
+            return 0.0f;
+
+        const float radius = 0.5f * Length(bbox.Width());
+        return std::max(Length(bbox.Center() - lod_context.m_camera_position) - radius, 0.0f);
+    }
+
+    // Return the diameter in pixels of the bounding sphere of a node seen at its distance from the camera,
+    // whether or not it is in the field of view. A flat mirror can't bring an object closer than that,
+    // so this also bounds the size of the object in flat reflections.
+    float get_projected_size(INode* node, const LODContext& lod_context, const TimeValue time)
+    {
+        const ObjectState object_state = node->EvalWorldState(time);
+        if (object_state.obj == nullptr)
+            return 0.0f;
+
+        Matrix3 object_to_world = node->GetObjTMAfterWSM(time);
+        Box3 bbox;
+        object_state.obj->GetDeformBBox(time, bbox, &object_to_world);
+        if (bbox.IsEmpty())
+            return 0.0f;
+
+        const float radius = 0.5f * Length(bbox.Width());
+        const float distance = Length(bbox.Center() - lod_context.m_camera_position) - radius;
+
+        return
+            distance > 0.0f
+                ? 2.0f * radius * lod_context.m_focal_length_in_pixels / distance
+                : std::numeric_limits<float>::max();
+    }
+
+    INode* get_lod_node(INode* node, const LODContext& lod_context, const TimeValue time)
+    {
+        if (!lod_context.m_enabled)
+            return node;
+
+        Object* object = node->GetObjectRef();
+        const AppleseedObjPropsMod* obj_props_mod = find_obj_props_mod(object);
+        if (obj_props_mod == nullptr)
+            return node;
+
+        const auto it = lod_context.m_shared_distances.find(object);
+        const float distance =
+            it != lod_context.m_shared_distances.end()
+                ? it->second
+                : get_camera_distance(node, lod_context, time);
+
+        return obj_props_mod->get_lod_node(node, distance, time);
+    }
+
+    // Return the average diffuse color of the material of a node, used to shade its stand-in.
+    Color get_average_diffuse_color(INode* node)
+    {
+        Mtl* mtl = node->GetMtl();
+        if (mtl == nullptr)
+            return Color(node->GetWireColor());
+
+        if (mtl->IsMultiMtl() && mtl->NumSubMtls() > 0)
+        {
+            Color sum(0.0f, 0.0f, 0.0f);
+            int count = 0;
+
+            for (int i = 0, e = mtl->NumSubMtls(); i < e; ++i)
+            {
+                Mtl* sub_mtl = mtl->GetSubMtl(i);
+                if (sub_mtl != nullptr)
+                {
+                    sum += sub_mtl->GetDiffuse();
+                    ++count;
+                }
+            }
+
+            if (count > 0)
+                return sum / static_cast<float>(count);
+        }
+
+        return mtl->GetDiffuse();
+    }
+
+    // Select the objects that can be rendered as boxes: all their instances must be smaller than
+    // the stand-in size on screen, and they must neither emit light nor be subdivided at render time.
+    void select_standin_objects(
+        const MaxSceneEntities&         entities,
+        const TimeValue                 time,
+        LODContext&                     lod_context)
+    {
+        struct Candidate
+        {
+            bool    m_eligible;
+            Color   m_color_sum;
+            size_t  m_instance_count;
+        };
+
+        const Candidate InitialCandidate = { true, Color(0.0f, 0.0f, 0.0f), 0 };
+        std::map<Object*, Candidate> candidates;
+
+        for (INode* node : entities.m_objects)
+        {
+            if (lod_context.m_lod_nodes.count(node) > 0)
+                continue;
+
+            INode* lod_node = get_lod_node(node, lod_context, time);
+            Object* object = lod_node->GetObjectRef();
+
+            Candidate& candidate =
+                candidates.insert(std::make_pair(object, InitialCandidate)).first->second;
+            if (!candidate.m_eligible)
+                continue;
+
+            const AppleseedObjPropsMod* obj_props_mod = find_obj_props_mod(object);
+            Mtl* mtl = lod_node->GetMtl();
+
+            // The size is measured on the original node since levels of detail are placed at its transform.
+            if ((mtl != nullptr && is_light_emitting_material(mtl)) ||
+                (obj_props_mod != nullptr && obj_props_mod->is_subdivision_enabled(time)) ||
+                get_projected_size(node, lod_context, time) >= lod_context.m_standin_size)
+            {
+                candidate.m_eligible = false;
+                continue;
+            }
+
+            candidate.m_color_sum += get_average_diffuse_color(lod_node);
+            ++candidate.m_instance_count;
+        }
+
+        size_t instance_count = 0;
+
+        for (const auto& entry : candidates)
+        {
+            const Candidate& candidate = entry.second;
+            if (candidate.m_eligible && candidate.m_instance_count > 0)
+            {
+                lod_context.m_standin_colors.insert(
+                    std::make_pair(
+                        entry.first,
+                        candidate.m_color_sum / static_cast<float>(candidate.m_instance_count)));
+                instance_count += candidate.m_instance_count;
+            }
+        }
+
+        RENDERER_LOG_INFO(
+            "replaced %s object%s (%s instance%s) smaller than %s pixel%s on screen by stand-ins.",
+            asf::pretty_uint(lod_context.m_standin_colors.size()).c_str(),
+            lod_context.m_standin_colors.size() > 1 ? "s" : "",
+            asf::pretty_uint(instance_count).c_str(),
+            instance_count > 1 ? "s" : "",
+            asf::pretty_scalar(lod_context.m_standin_size, 1).c_str(),
+            lod_context.m_standin_size > 1.0f ? "s" : "");
+    }
+
+    void prepare_lod_context(
+        const MaxSceneEntities&         entities,
+        const ViewParams&               view_params,
+        Bitmap*                         bitmap,
+        const TimeValue                 time,
+        LODContext&                     lod_context)
+    {
+        lod_context.m_camera_position = Inverse(view_params.affineTM).GetTrans();
+        lod_context.m_focal_length_in_pixels =
+            view_params.projType == PROJ_PERSPECTIVE
+                ? bitmap->Width() / (2.0f * std::tan(view_params.fov * 0.5f))
+                : 0.0f;
+
+        for (INode* node : entities.m_objects)
+        {
+            Object* object = node->GetObjectRef();
+            const AppleseedObjPropsMod* obj_props_mod = find_obj_props_mod(object);
+            if (obj_props_mod == nullptr)
+                continue;
+
+            // Instances of a subdivided object share the tessellation required by the nearest one.
+            if (obj_props_mod->is_subdivision_enabled(time))
+            {
+                const float distance = get_camera_surface_distance(node, lod_context, time);
+                const auto it = lod_context.m_surface_distances.find(object);
+                if (it == lod_context.m_surface_distances.end())
+                    lod_context.m_surface_distances.insert(std::make_pair(object, distance));
+                else it->second = std::min(it->second, distance);
+            }
+
+            std::vector<INode*> lod_nodes;
+            obj_props_mod->get_lod_nodes(time, lod_nodes);
+            if (lod_nodes.empty())
+                continue;
+
+            lod_context.m_lod_nodes.insert(lod_nodes.begin(), lod_nodes.end());
+
+            if (!obj_props_mod->is_lod_per_instance(time))
+            {
+                const float distance = get_camera_distance(node, lod_context, time);
+                const auto it = lod_context.m_shared_distances.find(object);
+                if (it == lod_context.m_shared_distances.end())
+                    lod_context.m_shared_distances.insert(std::make_pair(object, distance));
+                else it->second = std::min(it->second, distance);
+            }
+        }
+
+        // Stand-ins require perspective to estimate on-screen sizes.
+        if (lod_context.m_standin_size > 0.0f && lod_context.m_focal_length_in_pixels > 0.0f)
+            select_standin_objects(entities, time, lod_context);
+    }
+
+    // Return the number of pixels covered on screen by one world unit at the distance of the
+    // nearest instance of a node's object, or 0 if the node doesn't use render-time subdivision.
+    float get_pixels_per_unit(INode* node, const LODContext& lod_context, const TimeValue time)
+    {
+        if (!lod_context.m_enabled)
+            return 0.0f;
+
+        Object* object = node->GetObjectRef();
+        const AppleseedObjPropsMod* obj_props_mod = find_obj_props_mod(object);
+        if (obj_props_mod == nullptr || !obj_props_mod->is_subdivision_enabled(time))
+            return 0.0f;
+
+        // Without perspective, fall back to the maximum subdivision level.
+        if (lod_context.m_focal_length_in_pixels == 0.0f)
+            return std::numeric_limits<float>::max();
+
+        const auto it = lod_context.m_surface_distances.find(object);
+        const float distance =
+            it != lod_context.m_surface_distances.end()
+                ? it->second
+                : get_camera_surface_distance(node, lod_context, time);
+
+        return
+            distance > 0.0f
+                ? lod_context.m_focal_length_in_pixels / distance
+                : std::numeric_limits<float>::max();
+    }
+
     enum class RenderType
     {
         Default,
@@ -519,14 +985,15 @@ namespace
     };
 
     void create_object_instance(
-        asr::Assembly&          assembly,
-        INode*                  instance_node,
-        const asf::Transformd&  transform,
-        const ObjectInfo&       object_info,
-        const RenderType        type,
-        const bool              use_max_proc_maps,
-        const TimeValue         time,
-        MaterialMap&            material_map)
+        asr::Assembly&                  assembly,
+        INode*                          instance_node,
+        const asf::Transformd&          transform,
+        const ObjectInfo&               object_info,
+        const RenderType                type,
+        const bool                      use_max_proc_maps,
+        const TimeValue                 time,
+        MaterialMap&                    material_map,
+        const MaterialFootprintMap&     material_footprints)
     {
         // Compute a unique name for this instance.
         const std::string instance_name =
@@ -538,7 +1005,13 @@ namespace
 
         // Retrieve or create an appleseed material.
         Mtl* mtl = instance_node->GetMtl();
-        if (mtl)
+        if (!object_info.m_standin_material.empty())
+        {
+            // Stand-ins have a single material slot and a material of their own.
+            front_material_mappings.insert("material_slot_0", object_info.m_standin_material);
+            back_material_mappings.insert("material_slot_0", object_info.m_standin_material);
+        }
+        else if (mtl)
         {
             // The instance has a material.
 
@@ -561,6 +1034,7 @@ namespace
                                 instance_name,
                                 submtl,
                                 material_map,
+                                material_footprints,
                                 use_max_proc_maps,
                                 time);
 
@@ -589,6 +1063,7 @@ namespace
                         instance_name,
                         mtl,
                         material_map,
+                        material_footprints,
                         use_max_proc_maps,
                         time);
 
@@ -655,27 +1130,102 @@ namespace
     typedef std::map<Object*, std::vector<ObjectInfo>> ObjectMap;
     typedef std::map<Object*, std::string> AssemblyMap;
 
-    void add_object(
-        asr::Assembly&          assembly,
+    // Record the objects exported for `node` from the render meshes of `mesh_node`, its level of detail.
+    // The record is also stored under `mesh_node` so that edits to either node update the objects.
+    void record_exported_node(
+        ExportedNodeMap*                    exported_nodes,
+        INode*                              node,
+        INode*                              mesh_node,
+        const asr::Assembly&                assembly,
+        const std::vector<std::string>&     object_names,
+        const float                         pixels_per_unit)
+    {
+        if (exported_nodes == nullptr)
+            return;
+
+        ExportedNodeInfo& node_info = (*exported_nodes)[node];
+        node_info.m_mesh_node = mesh_node;
+        node_info.m_assembly_name = assembly.get_name();
+        node_info.m_object_names = object_names;
+        node_info.m_pixels_per_unit = pixels_per_unit;
+
+        if (mesh_node != node)
+            (*exported_nodes)[mesh_node] = node_info;
+    }
+
+    void record_exported_node(
+        ExportedNodeMap*        exported_nodes,
         INode*                  node,
-        const RenderType        type,
-        const bool              use_max_proc_maps,
-        const TimeValue         time,
-        ObjectMap&              object_map,
-        MaterialMap&            material_map,
-        AssemblyMap&            assembly_map)
+        INode*                  mesh_node,
+        const asr::Assembly&    assembly,
+        const float             pixels_per_unit)
     {
-        // Retrieve the geometrical object referenced by this node.
-        Object* object = node->GetObjectRef();
+        if (exported_nodes == nullptr)
+            return;
+
+        std::vector<std::string> object_names;
+        for (const auto& object : assembly.objects())
+            object_names.push_back(object.get_name());
+
+        record_exported_node(exported_nodes, node, mesh_node, assembly, object_names, pixels_per_unit);
+    }
 
+    void record_exported_node(
+        ExportedNodeMap*                exported_nodes,
+        INode*                          node,
+        INode*                          mesh_node,
+        const asr::Assembly&            assembly,
+        const std::vector<ObjectInfo>&  object_infos,
+        const float                     pixels_per_unit)
+    {
+        if (exported_nodes == nullptr)
+            return;
+
+        std::vector<std::string> object_names;
+        for (const auto& object_info : object_infos)
+            object_names.push_back(object_info.m_name);
+
+        record_exported_node(exported_nodes, node, mesh_node, assembly, object_names, pixels_per_unit);
+    }
+
+    void add_object(
+        asr::Assembly&                  assembly,
+        INode*                          node,
+        const RenderType                type,
+        const bool                      use_max_proc_maps,
+        const TimeValue                 time,
+        ObjectMap&                      object_map,
+        MaterialMap&                    material_map,
+        const MaterialFootprintMap&     material_footprints,
+        AssemblyMap&                    assembly_map,
+        const LODContext&               lod_context,
+        MeshCache*                      mesh_cache,
+        ExportedNodeMap*                exported_nodes)
+    {
         // Compute the transform of this instance.
         const asf::Transformd transform =
             asf::Transformd::from_local_to_parent(
                 to_matrix4d(node->GetObjTMAfterWSM(time)));
 
-        if (should_optimize_for_instancing(object, time))
+        const bool optimize_for_instancing = should_optimize_for_instancing(node->GetObjectRef(), time);
+
+        // Substitute the level of detail matching the distance to the camera.
+        // Geometry, materials and object properties are taken from the selected node.
+        INode* lod_node = get_lod_node(node, lod_context, time);
+
+        // Retrieve the geometrical object referenced by this node.
+        Object* object = lod_node->GetObjectRef();
+
+        // Screen-space density used for render-time subdivision.
+        const float pixels_per_unit = get_pixels_per_unit(lod_node, lod_context, time);
+
+        // Objects too small on screen are replaced by boxes shaded with the average color of their instances.
+        const auto standin = lod_context.m_standin_colors.find(object);
+        const bool use_standin = standin != lod_context.m_standin_colors.end();
+
+        if (optimize_for_instancing)
         {
-            std::string assembly_name = wide_to_utf8(node->GetName());
+            std::string assembly_name = wide_to_utf8(lod_node->GetName());
             assembly_name = make_unique_name(assembly.assemblies(), assembly_name + "_assembly");
 
             const AssemblyMap::const_iterator it = assembly_map.find(object);
@@ -687,21 +1237,26 @@ namespace
                     asr::AssemblyFactory().create(assembly_name.c_str()));
 
                 // Add objects and object instances to it.
-                const auto object_infos = create_mesh_objects(object_assembly.ref(), node, time);
+                const auto object_infos =
+                    use_standin
+                        ? create_standin_objects(object_assembly.ref(), lod_node, standin->second, time)
+                        : create_mesh_objects(object_assembly->objects(), lod_node, time, pixels_per_unit, mesh_cache);
                 for (const auto& object_info : object_infos)
                 {
                     create_object_instance(
                         object_assembly.ref(),
-                        node,
+                        lod_node,
                         asf::Transformd::identity(),
                         object_info,
                         type,
                         use_max_proc_maps,
                         time,
-                        material_map);
+                        material_map,
+                        material_footprints);
                 }
 
                 assembly_map.insert(std::make_pair(object, assembly_name));
+                record_exported_node(exported_nodes, node, lod_node, object_assembly.ref(), object_infos, pixels_per_unit);
                     
                 // Insert the assembly into the scene.
                 assembly.assemblies().insert(object_assembly);
@@ -709,6 +1264,12 @@ namespace
             else
             {
                 assembly_name = it->second;
+                record_exported_node(
+                    exported_nodes,
+                    node,
+                    lod_node,
+                    *assembly.assemblies().get_by_name(assembly_name.c_str()),
+                    pixels_per_unit);
             }
 
             // Create an instance of the assembly and insert it into the scene.
@@ -732,55 +1293,71 @@ namespace
             if (it == object_map.end())
             {
                 // The appleseed objects do not exist yet, create and instantiate them.
-                const auto object_infos = create_mesh_objects(assembly, node, time);
+                const auto object_infos =
+                    use_standin
+                        ? create_standin_objects(assembly, lod_node, standin->second, time)
+                        : create_mesh_objects(assembly.objects(), lod_node, time, pixels_per_unit, mesh_cache);
                 object_map.insert(std::make_pair(object, object_infos));
+                record_exported_node(exported_nodes, node, lod_node, assembly, object_infos, pixels_per_unit);
 
                 for (const auto& object_info : object_infos)
                 {
                     create_object_instance(
                         assembly,
-                        node,
+                        lod_node,
                         transform,
                         object_info,
                         type,
                         use_max_proc_maps,
                         time,
-                        material_map);
+                        material_map,
+                        material_footprints);
                 }
             }
             else
             {
                 // The appleseed objects already exist, simply instantiate them.
+                record_exported_node(exported_nodes, node, lod_node, assembly, it->second, pixels_per_unit);
                 for (const auto& object_info : it->second)
                 {
                     create_object_instance(
                         assembly,
-                        node,
+                        lod_node,
                         transform,
                         object_info,
                         type,
                         use_max_proc_maps,
                         time,
-                        material_map);
+                        material_map,
+                        material_footprints);
                 }
             }
         }
     }
 
     void add_objects(
-        asr::Assembly&          assembly,
-        const MaxSceneEntities& entities,
-        const RenderType        type,
-        const bool              use_max_proc_maps,
-        const TimeValue         time,
-        ObjectMap&              object_map,
-        MaterialMap&            material_map,
-        AssemblyMap&            assembly_map,
-        RendProgressCallback*   progress_cb)
+        asr::Assembly&                  assembly,
+        const MaxSceneEntities&         entities,
+        const RenderType                type,
+        const bool                      use_max_proc_maps,
+        const TimeValue                 time,
+        ObjectMap&                      object_map,
+        MaterialMap&                    material_map,
+        const MaterialFootprintMap&     material_footprints,
+        AssemblyMap&                    assembly_map,
+        const LODContext&               lod_context,
+        MeshCache*                      mesh_cache,
+        ExportedNodeMap*                exported_nodes,
+        RendProgressCallback*           progress_cb)
     {
         for (size_t i = 0, e = entities.m_objects.size(); i < e; ++i)
         {
             const auto& object = entities.m_objects[i];
+
+            // Nodes only used as levels of detail are exported through the nodes referencing them.
+            if (lod_context.m_lod_nodes.count(object) > 0)
+                continue;
+
             add_object(
                 assembly,
                 object,
@@ -789,7 +1366,11 @@ namespace
                 time,
                 object_map,
                 material_map,
-                assembly_map);
+                material_footprints,
+                assembly_map,
+                lod_context,
+                mesh_cache,
+                exported_nodes);
 
             const int done = static_cast<int>(i);
             const int total = static_cast<int>(e);
@@ -1067,26 +1648,6 @@ namespace
         }
     }
 
-    bool is_light_emitting_material(Mtl* mtl)
-    {
-        IAppleseedMtl* appleseed_mtl =
-            static_cast<IAppleseedMtl*>(mtl->GetInterface(IAppleseedMtl::interface_id()));
-        if (appleseed_mtl != nullptr && appleseed_mtl->can_emit_light())
-            return true;
-
-        for (int i = 0, e = mtl->NumSubMtls(); i < e; ++i)
-        {
-            Mtl* sub_mtl = mtl->GetSubMtl(i);
-            if (sub_mtl != nullptr)
-            {
-                if (is_light_emitting_material(sub_mtl))
-                    return true;
-            }
-        }
-
-        return false;
-    }
-
     bool has_light_emitting_materials(const MaterialMap& material_map)
     {
         for (const auto& entry : material_map)
@@ -1099,17 +1660,95 @@ namespace
         return false;
     }
 
+    void record_material_footprint(
+        MaterialFootprintMap&   material_footprints,
+        Mtl*                    mtl,
+        const float             footprint)
+    {
+        if (mtl == nullptr)
+            return;
+
+        float& material_footprint = material_footprints[mtl];
+        material_footprint = std::max(material_footprint, footprint);
+
+        for (int i = 0, e = mtl->NumSubMtls(); i < e; ++i)
+            record_material_footprint(material_footprints, mtl->GetSubMtl(i), footprint);
+    }
+
+    // Estimate, for each material, the largest size in pixels that objects using it can have on screen.
+    void compute_material_footprints(
+        const MaxSceneEntities& entities,
+        const ViewParams&       view_params,
+        Bitmap*                 bitmap,
+        const TimeValue         time,
+        MaterialFootprintMap&   material_footprints)
+    {
+        // Only perspective views are supported; materials without a footprint use full resolution textures.
+        if (view_params.projType != PROJ_PERSPECTIVE)
+            return;
+
+        const Point3 camera_position = Inverse(view_params.affineTM).GetTrans();
+        const float focal_length_in_pixels = bitmap->Width() / (2.0f * std::tan(view_params.fov * 0.5f));
+
+        for (const auto& node : entities.m_objects)
+        {
+            const ObjectState object_state = node->EvalWorldState(time);
+            if (object_state.obj == nullptr)
+                continue;
+
+            Matrix3 object_to_world = node->GetObjTMAfterWSM(time);
+            Box3 bbox;
+            object_state.obj->GetDeformBBox(time, bbox, &object_to_world);
+            if (bbox.IsEmpty())
+                continue;
+
+            const float radius = 0.5f * Length(bbox.Width());
+            const float distance = Length(bbox.Center() - camera_position) - radius;
+
+            // Objects enclosing the camera can cover the whole image at any magnification.
+            const float footprint =
+                distance > 0.0f
+                    ? 2.0f * radius * focal_length_in_pixels / distance
+                    : std::numeric_limits<float>::max();
+
+            record_material_footprint(material_footprints, node->GetMtl(), footprint);
+        }
+    }
+
     void populate_assembly(
         asr::Scene&                         scene,
         asr::Assembly&                      assembly,
         const RendParams&                   rend_params,
+        const ViewParams&                   view_params,
+        Bitmap*                             bitmap,
         const MaxSceneEntities&             entities,
         const std::vector<DefaultLight>&    default_lights,
         const RenderType                    type,
         const RendererSettings&             settings,
         const TimeValue                     time,
-        RendProgressCallback*               progress_cb)
+        RendProgressCallback*               progress_cb,
+        ExportedNodeMap*                    exported_nodes)
     {
+        // Estimate on-screen sizes of materials to pick reduced texture variants.
+        MaterialFootprintMap material_footprints;
+        if (settings.m_use_texture_variants && type == RenderType::Default)
+            compute_material_footprints(entities, view_params, bitmap, time, material_footprints);
+
+        // Select levels of detail and subdivision levels based on the distance to the camera.
+        LODContext lod_context;
+        lod_context.m_enabled = type == RenderType::Default;
+
+        // Interactive sessions rebuild meshes of modified nodes in place, which stand-ins don't support.
+        lod_context.m_standin_size =
+            settings.m_enable_standins && exported_nodes == nullptr ? settings.m_standin_size : 0.0f;
+        if (lod_context.m_enabled)
+            prepare_lod_context(entities, view_params, bitmap, time, lod_context);
+
+        // Reuse meshes converted by previous renders, including in previous 3ds Max sessions.
+        std::unique_ptr<MeshCache> mesh_cache;
+        if (settings.m_use_mesh_cache && type == RenderType::Default)
+            mesh_cache.reset(new MeshCache(settings.m_mesh_cache_size * 1024 * 1024));
+
         // Add objects, object instances and materials to the assembly.
         ObjectMap object_map;
         MaterialMap material_map;
@@ -1122,9 +1761,16 @@ namespace
             time,
             object_map,
             material_map,
+            material_footprints,
             assembly_map,
+            lod_context,
+            mesh_cache.get(),
+            exported_nodes,
             progress_cb);
 
+        if (mesh_cache)
+            mesh_cache->trim();
+
         // Only add non-physical lights. Light-emitting materials were added by material plugins.
         add_lights(assembly, rend_params, entities, time);
 
@@ -1204,7 +1850,15 @@ namespace
         else
         {
             std::string env_tex_instance_name;
-            if (settings.m_use_max_procedural_maps)
+            if (is_file_bitmap_texture(rend_params.envMap))
+            {
+                // Reference the file directly: appleseed streams it from disk through its texture cache.
+                env_tex_instance_name =
+                    insert_bitmap_texture_and_instance(
+                        scene,
+                        static_cast<BitmapTex*>(rend_params.envMap));
+            }
+            else if (settings.m_use_max_procedural_maps)
             {
                 env_tex_instance_name =
                     insert_procedural_texture_and_instance(
@@ -1265,13 +1919,14 @@ namespace
             asr::ParamArray env_edf_params;
             env_edf_params.insert("radiance", env_tex_instance_name.c_str());
 
-            if (is_bitmap_texture(rend_params.envMap))
+            if (is_file_bitmap_texture(rend_params.envMap) || is_bitmap_texture(rend_params.envMap))
             {
+                // The output amount is a linear multiplier.
                 TextureOutput* tex_out = static_cast<BitmapTex*>(rend_params.envMap)->GetTexout();
                 if (tex_out)
                 {
                     const float output = static_cast<StdTexoutGen*>(tex_out)->GetOutAmt(time);
-                    env_edf_params.insert("exposure", output - 1.0f);
+                    env_edf_params.insert("radiance_multiplier", output);
                 }
             }
 
@@ -1481,6 +2136,18 @@ namespace
                 }
             }
 
+            // The shading cost report attributes per-pixel render times to materials.
+            if (settings.m_enable_shading_cost_report)
+            {
+                const asr::IAOVFactory* factory = g_aov_factory_registrar.lookup("pixel_time_aov");
+                if (factory != nullptr)
+                {
+                    asf::auto_release_ptr<asr::AOV> aov_entity = factory->create(asr::ParamArray());
+                    if (aovs.get_by_name(aov_entity->get_name()) == nullptr)
+                        aovs.insert(aov_entity);
+                }
+            }
+
             asf::auto_release_ptr<asr::Frame> frame(
                 asr::FrameFactory::create(
                     "beauty",
@@ -1647,7 +2314,8 @@ asf::auto_release_ptr<asr::Project> build_project(
     const RendererSettings&                 settings,
     Bitmap*                                 bitmap,
     const TimeValue                         time,
-    RendProgressCallback*                   progress_cb)
+    RendProgressCallback*                   progress_cb,
+    ExportedNodeMap*                        exported_nodes)
 {
     // Create an empty project.
     asf::auto_release_ptr<asr::Project> project(
@@ -1664,6 +2332,15 @@ asf::auto_release_ptr<asr::Project> build_project(
     // Create a scene.
     asf::auto_release_ptr<asr::Scene> scene(asr::SceneFactory::create());
 
+    // Share bitmap textures between all assemblies.
+    SharedTextureScope shared_texture_scope(scene.ref());
+
+    // Optionally bake bitmaps used as bump maps into normal maps.
+    BumpMapBakingScope bump_map_baking_scope(settings.m_bake_bump_maps);
+
+    // Optionally threshold bitmaps used as alpha maps into cutout masks.
+    CutoutMaskScope cutout_mask_scope(settings.m_cutout_alpha_maps);
+
     // Setup the environment.
     setup_environment(
         scene.ref(),
@@ -1683,12 +2360,15 @@ asf::auto_release_ptr<asr::Project> build_project(
         scene.ref(),
         assembly.ref(),
         rend_params,
+        view_params,
+        bitmap,
         entities,
         default_lights,
         type,
         settings,
         time,
-        progress_cb);
+        progress_cb,
+        exported_nodes);
 
     // Create an instance of the assembly and insert it into the scene.
     asf::auto_release_ptr<asr::AssemblyInstance> assembly_instance(
@@ -1724,3 +2404,12 @@ asf::auto_release_ptr<asr::Project> build_project(
 
     return project;
 }
+
+bool rebuild_mesh_objects(
+    asr::ObjectContainer&                   objects,
+    const ExportedNodeInfo&                 node_info,
+    const TimeValue                         time)
+{
+    const auto object_infos = create_mesh_objects(objects, node_info.m_mesh_node, time, node_info.m_pixels_per_unit, nullptr, &node_info.m_object_names);
+    return object_infos.size() == node_info.m_object_names.size();
+}
@@ -28,6 +28,9 @@
 
 #pragma once
 
+// appleseed.renderer headers.
+#include "renderer/api/scene.h"
+
 // appleseed.foundation headers.
 #include "foundation/platform/windows.h"    // include before 3ds Max headers
 #include "foundation/utility/autoreleaseptr.h"
@@ -37,6 +40,8 @@
 #include <render.h>
 
 // Standard headers.
+#include <map>
+#include <string>
 #include <vector>
 
 // Forward declarations.
@@ -50,6 +55,24 @@ class RendererSettings;
 class RendParams;
 class ViewParams;
 
+// appleseed entities exported for a given 3ds Max node. Nodes replaced by a level of detail are recorded
+// both under their own key and under the key of the level of detail whose render meshes were exported.
+struct ExportedNodeInfo
+{
+    INode*                      m_mesh_node;        // node whose render meshes were exported
+    std::string                 m_assembly_name;    // name of the assembly holding the node's objects
+    std::vector<std::string>    m_object_names;     // names of the objects built from the node's render meshes
+    float                       m_pixels_per_unit;  // screen-space density used for render-time subdivision
+
+    ExportedNodeInfo()
+      : m_mesh_node(nullptr)
+      , m_pixels_per_unit(0.0f)
+    {
+    }
+};
+
+typedef std::map<INode*, ExportedNodeInfo> ExportedNodeMap;
+
 // Build an appleseed project from the current 3ds Max scene.
 foundation::auto_release_ptr<renderer::Project> build_project(
     const MaxSceneEntities&             entities,
@@ -61,7 +84,8 @@ foundation::auto_release_ptr<renderer::Project> build_project(
     const RendererSettings&             settings,
     Bitmap*                             bitmap,
     const TimeValue                     time,
-    RendProgressCallback*               progress_cb);
+    RendProgressCallback*               progress_cb,
+    ExportedNodeMap*                    exported_nodes = nullptr);
 
 foundation::auto_release_ptr<renderer::Camera> build_camera(
     INode*                              view_node,
@@ -69,3 +93,10 @@ foundation::auto_release_ptr<renderer::Camera> build_camera(
     Bitmap*                             bitmap,
     const RendererSettings&             settings,
     const TimeValue                     time);
+
+// Rebuild the mesh objects of a previously exported node into `objects`, reusing their original names.
+// Return false if the node no longer has the same number of render meshes.
+bool rebuild_mesh_objects(
+    renderer::ObjectContainer&          objects,
+    const ExportedNodeInfo&             node_info,
+    const TimeValue                     time);
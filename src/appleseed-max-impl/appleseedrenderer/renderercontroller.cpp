@@ -53,6 +53,20 @@ RendererController::RendererController(
 void RendererController::on_rendering_begin()
 {
     m_status = ContinueRendering;
+    m_rendering_begin_time = Clock::now();
+    m_frame_begin_time = m_rendering_begin_time;
+    m_frame_end_time = m_rendering_begin_time;
+}
+
+void RendererController::on_frame_begin()
+{
+    m_frame_begin_time = Clock::now();
+    m_frame_end_time = m_frame_begin_time;
+}
+
+void RendererController::on_frame_end()
+{
+    m_frame_end_time = Clock::now();
 }
 
 void RendererController::on_progress()
@@ -71,3 +85,13 @@ asr::IRendererController::Status RendererController::get_status() const
 {
     return m_status;
 }
+
+double RendererController::get_scene_preparation_time() const
+{
+    return std::chrono::duration<double>(m_frame_begin_time - m_rendering_begin_time).count();
+}
+
+double RendererController::get_frame_time() const
+{
+    return std::chrono::duration<double>(m_frame_end_time - m_frame_begin_time).count();
+}
@@ -35,6 +35,7 @@
 #include "foundation/platform/types.h"
 
 // Standard headers.
+#include <chrono>
 #include <cstddef>
 
 // Forward declarations.
@@ -51,13 +52,28 @@ class RendererController
 
     void on_rendering_begin() override;
 
+    void on_frame_begin() override;
+
+    void on_frame_end() override;
+
     void on_progress() override;
 
     Status get_status() const override;
 
+    // Time spent by the renderer preparing the scene before the frame, in seconds.
+    double get_scene_preparation_time() const;
+
+    // Time spent by the renderer on the frame itself, in seconds.
+    double get_frame_time() const;
+
   private:
+    typedef std::chrono::steady_clock Clock;
+
     RendProgressCallback*               m_progress_cb;
     volatile foundation::uint32*        m_rendered_tile_count;
     const size_t                        m_total_tile_count;
     Status                              m_status;
+    Clock::time_point                   m_rendering_begin_time;
+    Clock::time_point                   m_frame_begin_time;
+    Clock::time_point                   m_frame_end_time;
 };
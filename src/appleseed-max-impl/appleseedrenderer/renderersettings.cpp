@@ -40,6 +40,10 @@
 // 3ds Max headers.
 #include <ioapi.h>
 
+// Standard headers.
+#include <map>
+
+namespace asf = foundation;
 namespace asr = renderer;
 
 namespace
@@ -118,6 +122,20 @@ namespace
             m_low_priority_mode = true;
             m_use_max_procedural_maps = false;
             m_texture_cache_size = 1024;    // value in MB
+            m_use_texture_variants = false;
+            m_log_memory_usage = false;
+            m_write_memory_report = false;
+            m_enable_shading_cost_report = false;
+            m_enable_standins = false;
+            m_standin_size = 2.0f;
+            m_use_mesh_cache = false;
+            m_mesh_cache_size = 4096;    // value in MB
+            m_bake_bump_maps = false;
+            m_preview_sequence_frames = 1;    // 1 = render animation frames one at a time
+            m_cutout_alpha_maps = false;
+            m_osl_texture_cache_size = 1024;    // value in MB
+            m_osl_texture_max_open_files = 100;
+            m_osl_texture_automip = false;
 
             const int log_open_mode = load_system_setting(L"LogOpenMode", static_cast<int>(DialogLogTarget::OpenMode::Errors));
             m_log_open_mode = static_cast<DialogLogTarget::OpenMode>(log_open_mode);
@@ -134,6 +152,20 @@ namespace
             m_denoise_scales = 3;
         }
     };
+
+    typedef std::map<std::string, std::string> FlatParameters;
+
+    void flatten_parameters(
+        const asf::Dictionary&  dictionary,
+        const std::string&      prefix,
+        FlatParameters&         values)
+    {
+        for (auto i = dictionary.strings().begin(), e = dictionary.strings().end(); i != e; ++i)
+            values[prefix + i.key()] = i.value();
+
+        for (auto i = dictionary.dictionaries().begin(), e = dictionary.dictionaries().end(); i != e; ++i)
+            flatten_parameters(i.value(), prefix + i.key() + ".", values);
+    }
 }
 
 const char* get_shader_override_type(const int shader_override_type)
@@ -214,17 +246,59 @@ const RendererSettings& RendererSettings::defaults()
 
 void RendererSettings::apply(asr::Project& project) const
 {
-    apply_common_settings(project, "final");
-    apply_common_settings(project, "interactive");
+    asr::ParamArray& final_params = project.configurations().get_by_name("final")->get_parameters();
+    asr::ParamArray& interactive_params = project.configurations().get_by_name("interactive")->get_parameters();
 
-    apply_settings_to_final_config(project);
-    apply_settings_to_interactive_config(project);
+    apply_common_settings(final_params);
+    apply_common_settings(interactive_params);
+
+    apply_settings_to_final_config(final_params);
+    apply_settings_to_interactive_config(interactive_params);
 }
 
-void RendererSettings::apply_common_settings(asr::Project& project, const char* config_name) const
+RendererSettings::ConfigChanges RendererSettings::diff_interactive_config(const RendererSettings& previous) const
 {
-    asr::ParamArray& params = project.configurations().get_by_name(config_name)->get_parameters();
+    // Generate both parameter sets the same way apply() does so that the diff can never drift from it.
+    asr::ParamArray previous_params;
+    previous.apply_common_settings(previous_params);
+    previous.apply_settings_to_interactive_config(previous_params);
+
+    asr::ParamArray current_params;
+    apply_common_settings(current_params);
+    apply_settings_to_interactive_config(current_params);
+
+    FlatParameters previous_values;
+    flatten_parameters(previous_params, std::string(), previous_values);
+
+    FlatParameters current_values;
+    flatten_parameters(current_params, std::string(), current_values);
+
+    ConfigChanges changes;
+
+    for (const auto& value : current_values)
+    {
+        const auto it = previous_values.find(value.first);
+        if (it == previous_values.end() || it->second != value.second)
+        {
+            const ConfigChange change = { value.first, value.second, false };
+            changes.push_back(change);
+        }
+    }
+
+    for (const auto& value : previous_values)
+    {
+        if (current_values.find(value.first) == current_values.end())
+        {
+            const ConfigChange change = { value.first, std::string(), true };
+            changes.push_back(change);
+        }
+    }
 
+    return changes;
+}
+
+void RendererSettings::apply_common_settings(asr::ParamArray& params) const
+{
     params.insert_path("sampling_mode", "qmc");
     params.insert_path("lighting_engine", get_lighting_engine_type(m_lighting_algorithm));
 
@@ -294,10 +368,8 @@ void RendererSettings::apply_common_settings(asr::Project& project, const char*
        params.insert_path("shading_engine.override_shading.mode", get_shader_override_type(m_shader_override));  
 }
 
-void RendererSettings::apply_settings_to_final_config(asr::Project& project) const
+void RendererSettings::apply_settings_to_final_config(asr::ParamArray& params) const
 {
-    asr::ParamArray& params = project.configurations().get_by_name("final")->get_parameters();
-
     params.insert_path("generic_frame_renderer.tile_ordering", "spiral");
     params.insert_path("passes", m_passes);
     params.insert_path("shading_result_framebuffer", m_passes == 1 ? "ephemeral" : "permanent");
@@ -319,10 +391,8 @@ void RendererSettings::apply_settings_to_final_config(asr::Project& project) con
     }
 }
 
-void RendererSettings::apply_settings_to_interactive_config(asr::Project& project) const
+void RendererSettings::apply_settings_to_interactive_config(asr::ParamArray& params) const
 {
-    asr::ParamArray& params = project.configurations().get_by_name("interactive")->get_parameters();
-
     params.insert_path("frame_renderer", "progressive");
     params.insert_path("sample_generator", "generic");
     params.insert_path("sample_renderer", "generic");
@@ -685,6 +755,62 @@ bool RendererSettings::save(ISave* isave) const
         isave->BeginChunk(ChunkSettingsSystemTextureCacheSize);
         success &= write<foundation::uint64>(isave, m_texture_cache_size);
         isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemUseTextureVariants);
+        success &= write<bool>(isave, m_use_texture_variants);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemLogMemoryUsage);
+        success &= write<bool>(isave, m_log_memory_usage);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemWriteMemoryReport);
+        success &= write<bool>(isave, m_write_memory_report);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemEnableShadingCostReport);
+        success &= write<bool>(isave, m_enable_shading_cost_report);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemEnableStandins);
+        success &= write<bool>(isave, m_enable_standins);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemStandinSize);
+        success &= write<float>(isave, m_standin_size);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemUseMeshCache);
+        success &= write<bool>(isave, m_use_mesh_cache);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemMeshCacheSize);
+        success &= write<foundation::uint64>(isave, m_mesh_cache_size);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemBakeBumpMaps);
+        success &= write<bool>(isave, m_bake_bump_maps);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemPreviewSequenceFrames);
+        success &= write<int>(isave, m_preview_sequence_frames);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemCutoutAlphaMaps);
+        success &= write<bool>(isave, m_cutout_alpha_maps);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemOSLTextureCacheSize);
+        success &= write<foundation::uint64>(isave, m_osl_texture_cache_size);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemOSLTextureMaxOpenFiles);
+        success &= write<int>(isave, m_osl_texture_max_open_files);
+        isave->EndChunk();
+
+        isave->BeginChunk(ChunkSettingsSystemOSLTextureAutomip);
+        success &= write<bool>(isave, m_osl_texture_automip);
+        isave->EndChunk();
         
     isave->EndChunk();
 
@@ -1136,6 +1262,62 @@ IOResult RendererSettings::load_system_settings(ILoad* iload)
           case ChunkSettingsSystemTextureCacheSize:
             result = read<foundation::uint64>(iload, &m_texture_cache_size);
             break;
+
+          case ChunkSettingsSystemUseTextureVariants:
+            result = read<bool>(iload, &m_use_texture_variants);
+            break;
+
+          case ChunkSettingsSystemLogMemoryUsage:
+            result = read<bool>(iload, &m_log_memory_usage);
+            break;
+
+          case ChunkSettingsSystemWriteMemoryReport:
+            result = read<bool>(iload, &m_write_memory_report);
+            break;
+
+          case ChunkSettingsSystemEnableShadingCostReport:
+            result = read<bool>(iload, &m_enable_shading_cost_report);
+            break;
+
+          case ChunkSettingsSystemEnableStandins:
+            result = read<bool>(iload, &m_enable_standins);
+            break;
+
+          case ChunkSettingsSystemStandinSize:
+            result = read<float>(iload, &m_standin_size);
+            break;
+
+          case ChunkSettingsSystemUseMeshCache:
+            result = read<bool>(iload, &m_use_mesh_cache);
+            break;
+
+          case ChunkSettingsSystemMeshCacheSize:
+            result = read<foundation::uint64>(iload, &m_mesh_cache_size);
+            break;
+
+          case ChunkSettingsSystemBakeBumpMaps:
+            result = read<bool>(iload, &m_bake_bump_maps);
+            break;
+
+          case ChunkSettingsSystemPreviewSequenceFrames:
+            result = read<int>(iload, &m_preview_sequence_frames);
+            break;
+
+          case ChunkSettingsSystemCutoutAlphaMaps:
+            result = read<bool>(iload, &m_cutout_alpha_maps);
+            break;
+
+          case ChunkSettingsSystemOSLTextureCacheSize:
+            result = read<foundation::uint64>(iload, &m_osl_texture_cache_size);
+            break;
+
+          case ChunkSettingsSystemOSLTextureMaxOpenFiles:
+            result = read<int>(iload, &m_osl_texture_max_open_files);
+            break;
+
+          case ChunkSettingsSystemOSLTextureAutomip:
+            result = read<bool>(iload, &m_osl_texture_automip);
+            break;
         }
 
         if (result != IO_OK)
@@ -40,8 +40,10 @@
 
 // Standard headers.
 #include <string>
+#include <vector>
 
 // Forward declarations.
+namespace renderer  { class ParamArray; }
 namespace renderer  { class Project; }
 class ILoad;
 class ISave;
@@ -180,10 +182,38 @@ class RendererSettings
     DialogLogTarget::OpenMode   m_log_open_mode;
     bool                        m_log_material_editor_messages;
     foundation::uint64          m_texture_cache_size;
+    bool                        m_use_texture_variants;
+    bool                        m_log_memory_usage;
+    bool                        m_write_memory_report;
+    bool                        m_enable_shading_cost_report;
+    bool                        m_enable_standins;
+    float                       m_standin_size;
+    bool                        m_use_mesh_cache;
+    foundation::uint64          m_mesh_cache_size;
+    bool                        m_bake_bump_maps;
+    int                         m_preview_sequence_frames;
+    bool                        m_cutout_alpha_maps;
+    foundation::uint64          m_osl_texture_cache_size;
+    int                         m_osl_texture_max_open_files;
+    bool                        m_osl_texture_automip;
 
     // Apply these settings to a given project.
     void apply(renderer::Project& project) const;
 
+    // A parameter of a rendering configuration that differs between two sets of settings.
+    struct ConfigChange
+    {
+        std::string     m_path;
+        std::string     m_value;
+        bool            m_removed;
+    };
+
+    typedef std::vector<ConfigChange> ConfigChanges;
+
+    // Compute the changes to the "interactive" configuration parameters
+    // needed to go from `previous` to these settings.
+    ConfigChanges diff_interactive_config(const RendererSettings& previous) const;
+
     // Save settings to a 3ds Max file.
     bool save(ISave* isave) const;
 
@@ -199,7 +229,7 @@ class RendererSettings
     IOResult load_system_settings(ILoad* iload);
     IOResult load_postprocessing_settings(ILoad* iload);
 
-    void apply_common_settings(renderer::Project& project, const char* config_name) const;
-    void apply_settings_to_final_config(renderer::Project& project) const;
-    void apply_settings_to_interactive_config(renderer::Project& project) const;
+    void apply_common_settings(renderer::ParamArray& params) const;
+    void apply_settings_to_final_config(renderer::ParamArray& params) const;
+    void apply_settings_to_interactive_config(renderer::ParamArray& params) const;
 };
@@ -0,0 +1,122 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "renderstatistics.h"
+
+// appleseed-max headers.
+#include "appleseedrenderer/renderersettings.h"
+#include "utilities.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/system.h"
+#include "foundation/platform/windows.h"    // include before 3ds Max headers
+#include "foundation/utility/string.h"
+
+// 3ds Max headers.
+#include <max.h>
+
+// Standard headers.
+#include <string>
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+    size_t get_samples_per_pixel(const RendererSettings& settings)
+    {
+        const int samples =
+            settings.m_sampler_type == 0
+                ? settings.m_uniform_pixel_samples
+                : settings.m_adaptive_max_samples;
+
+        return static_cast<size_t>(settings.m_passes * samples);
+    }
+
+    size_t get_thread_count(const RendererSettings& settings)
+    {
+        return
+            settings.m_rendering_threads > 0
+                ? static_cast<size_t>(settings.m_rendering_threads)
+                : asf::System::get_logical_cpu_core_count();
+    }
+}
+
+RenderStatistics::RenderStatistics()
+  : m_build_time(0.0)
+  , m_scene_preparation_time(0.0)
+  , m_frame_time(0.0)
+  , m_pixel_count(0)
+  , m_rendered_tile_count(0)
+{
+}
+
+void print_render_summary(
+    const RenderStatistics&     statistics,
+    const RendererSettings&     settings)
+{
+    const size_t thread_count = get_thread_count(settings);
+    const size_t samples_per_pixel = get_samples_per_pixel(settings);
+
+    std::string summary =
+        asf::format(
+            "render summary: {0} build, {1} scene preparation, {2} rendering, {3} spp, {4} thread{5}",
+            asf::pretty_time(statistics.m_build_time),
+            asf::pretty_time(statistics.m_scene_preparation_time),
+            asf::pretty_time(statistics.m_frame_time),
+            asf::pretty_uint(samples_per_pixel),
+            asf::pretty_uint(thread_count),
+            thread_count > 1 ? "s" : "");
+
+    std::string status_line =
+        asf::format("appleseed: {0} rendering", asf::pretty_time(statistics.m_frame_time));
+
+    // Adaptive sampling may take fewer samples: this is an upper bound in that case.
+    if (statistics.m_pixel_count > 0 && statistics.m_frame_time > 0.0)
+    {
+        const double total_samples = static_cast<double>(statistics.m_pixel_count) * samples_per_pixel;
+        const double samples_per_second = total_samples / statistics.m_frame_time;
+        summary +=
+            asf::format(
+                "\n  pixels: {0} in {1} tile{2}, {3} samples/s, {4} samples/s/thread",
+                asf::pretty_uint(statistics.m_pixel_count),
+                asf::pretty_uint(statistics.m_rendered_tile_count),
+                statistics.m_rendered_tile_count > 1 ? "s" : "",
+                asf::pretty_scalar(samples_per_second, 0),
+                asf::pretty_scalar(samples_per_second / thread_count, 0));
+        status_line += asf::format(", {0} samples/s", asf::pretty_scalar(samples_per_second, 0));
+    }
+
+    RENDERER_LOG_INFO("%s", summary.c_str());
+
+    GetCOREInterface()->ReplacePrompt(utf8_to_wide(status_line).c_str());
+}
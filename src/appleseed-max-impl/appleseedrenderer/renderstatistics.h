@@ -0,0 +1,56 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+class RendererSettings;
+
+//
+// Statistics of a final render, gathered from the renderer controller and the
+// frame rather than from appleseed's log output.
+//
+
+struct RenderStatistics
+{
+    double  m_build_time;               // project build, in seconds
+    double  m_scene_preparation_time;   // renderer setup before the frame, in seconds
+    double  m_frame_time;               // frame rendering, in seconds
+    size_t  m_pixel_count;
+    size_t  m_rendered_tile_count;
+
+    RenderStatistics();
+};
+
+// Print a short summary of `statistics` to the log window, the 3ds Max log and the status bar.
+void print_render_summary(
+    const RenderStatistics&     statistics,
+    const RendererSettings&     settings);
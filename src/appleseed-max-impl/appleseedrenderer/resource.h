@@ -131,6 +131,25 @@
 #define IDC_TEXT_TEXTURE_CACHE_SIZE                     506
 #define IDC_SPINNER_TEXTURE_CACHE_SIZE                  507
 #define IDC_CHECK_ENABLE_EMBREE                         508
+#define IDC_CHECK_USE_TEXTURE_VARIANTS                  509
+#define IDC_CHECK_LOG_MEMORY_USAGE                      510
+#define IDC_CHECK_WRITE_MEMORY_REPORT                   511
+#define IDC_CHECK_ENABLE_SHADING_COST_REPORT            512
+#define IDC_CHECK_ENABLE_STANDINS                       513
+#define IDC_TEXT_STANDIN_SIZE                           514
+#define IDC_SPINNER_STANDIN_SIZE                        515
+#define IDC_CHECK_USE_MESH_CACHE                        516
+#define IDC_TEXT_MESH_CACHE_SIZE                        517
+#define IDC_SPINNER_MESH_CACHE_SIZE                     518
+#define IDC_CHECK_BAKE_BUMP_MAPS                        519
+#define IDC_TEXT_PREVIEW_SEQUENCE_FRAMES                520
+#define IDC_SPINNER_PREVIEW_SEQUENCE_FRAMES             521
+#define IDC_CHECK_CUTOUT_ALPHA_MAPS                     522
+#define IDC_TEXT_OSL_TEXTURE_CACHE_SIZE                 523
+#define IDC_SPINNER_OSL_TEXTURE_CACHE_SIZE              524
+#define IDC_TEXT_OSL_TEXTURE_MAX_OPEN_FILES             525
+#define IDC_SPINNER_OSL_TEXTURE_MAX_OPEN_FILES          526
+#define IDC_CHECK_OSL_TEXTURE_AUTOMIP                   527
 #define IDD_DIALOG_LOG                                  600
 #define IDC_COMBO_LOG                                   601
 #define IDC_STATIC_LOG                                  602
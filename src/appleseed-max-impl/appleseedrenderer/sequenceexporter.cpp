@@ -0,0 +1,253 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "sequenceexporter.h"
+
+// appleseed-max headers.
+#include "utilities.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+#include "renderer/api/project.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/string.h"
+
+// RapidJSON headers.
+#include "3rdparty/rapidjson/prettywriter.h"
+#include "3rdparty/rapidjson/stringbuffer.h"
+
+// Boost headers.
+#include "boost/filesystem.hpp"
+
+// Windows headers.
+#include <locale.h>
+
+// Standard headers.
+#include <algorithm>
+#include <clocale>
+#include <cstdio>
+#include <fstream>
+
+namespace asf = foundation;
+namespace asr = renderer;
+namespace bfs = boost::filesystem;
+namespace json = rapidjson;
+
+namespace
+{
+    // Return the name of the directory and of the project file of a given frame, e.g. "scene.0012".
+    std::wstring get_frame_name(const bfs::path& project_file_path, const int frame)
+    {
+        char frame_number[16];
+        std::snprintf(frame_number, sizeof(frame_number), "%04d", frame);
+
+        return project_file_path.stem().wstring() + L"." + utf8_to_wide(frame_number);
+    }
+
+    std::wstring get_project_file_extension(const bfs::path& project_file_path)
+    {
+        return
+            project_file_path.has_extension()
+                ? project_file_path.extension().wstring()
+                : std::wstring(L".appleseed");
+    }
+}
+
+SequenceProjectExporter::SequenceProjectExporter(
+    const std::wstring&                     project_file_path,
+    const size_t                            thread_count)
+  : m_project_file_path(project_file_path)
+  , m_max_pending_jobs(std::max<size_t>(thread_count, 1))
+  , m_start_time(Clock::now())
+  , m_stopping(false)
+{
+    for (size_t i = 0, e = std::max<size_t>(thread_count, 1); i < e; ++i)
+        m_threads.push_back(std::thread(&SequenceProjectExporter::worker_thread, this));
+}
+
+SequenceProjectExporter::~SequenceProjectExporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_job_queued.notify_all();
+
+    for (auto& thread : m_threads)
+        thread.join();
+
+    write_manifest();
+}
+
+void SequenceProjectExporter::write(
+    const int                               frame,
+    asf::auto_release_ptr<asr::Project>     project)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job_taken.wait(lock, [this]() { return m_jobs.size() < m_max_pending_jobs; });
+
+        Job job;
+        job.m_frame = frame;
+        job.m_project = project.release();
+        m_jobs.push_back(job);
+    }
+
+    m_job_queued.notify_one();
+}
+
+void SequenceProjectExporter::worker_thread()
+{
+    // Render() restores the user's locale while projects are still being written: give this
+    // thread its own "C" locale so that numbers are always written with a decimal point.
+    _configthreadlocale(_ENABLE_PER_THREAD_LOCALE);
+    std::setlocale(LC_ALL, "C");
+
+    while (true)
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_job_queued.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+
+            // Keep going until the queue is drained, even when stopping.
+            if (m_jobs.empty())
+                return;
+
+            job = m_jobs.front();
+            m_jobs.pop_front();
+        }
+
+        m_job_taken.notify_one();
+
+        asf::auto_release_ptr<asr::Project> project(job.m_project);
+        const ManifestEntry entry = write_project(job.m_frame, project.ref());
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_manifest.push_back(entry);
+        }
+    }
+}
+
+SequenceProjectExporter::ManifestEntry SequenceProjectExporter::write_project(
+    const int                               frame,
+    asr::Project&                           project) const
+{
+    const bfs::path project_file_path(m_project_file_path);
+    const std::wstring frame_name = get_frame_name(project_file_path, frame);
+    const std::wstring frame_filename = frame_name + get_project_file_extension(project_file_path);
+    const bfs::path frame_directory = project_file_path.parent_path() / frame_name;
+    const bfs::path frame_file_path = frame_directory / frame_filename;
+
+    ManifestEntry entry;
+    entry.m_frame = frame;
+    entry.m_project_file = wide_to_utf8(frame_name + L"/" + frame_filename);
+
+    // Each frame needs its own directory since frames write mesh files with identical names.
+    boost::system::error_code ec;
+    bfs::create_directories(frame_directory, ec);
+
+    entry.m_success =
+        !ec && asr::ProjectFileWriter::write(project, wide_to_utf8(frame_file_path.wstring()).c_str());
+
+    if (!entry.m_success)
+    {
+        RENDERER_LOG_ERROR(
+            "failed to write project file %s.",
+            wide_to_utf8(frame_file_path.wstring()).c_str());
+    }
+
+    return entry;
+}
+
+void SequenceProjectExporter::write_manifest()
+{
+    if (m_manifest.empty())
+        return;
+
+    std::sort(
+        m_manifest.begin(),
+        m_manifest.end(),
+        [](const ManifestEntry& lhs, const ManifestEntry& rhs) { return lhs.m_frame < rhs.m_frame; });
+
+    json::StringBuffer buffer;
+    json::PrettyWriter<json::StringBuffer> writer(buffer);
+
+    writer.StartObject();
+
+    writer.Key("frames");
+    writer.StartArray();
+    for (const ManifestEntry& entry : m_manifest)
+    {
+        writer.StartObject();
+        writer.Key("frame");
+        writer.Int(entry.m_frame);
+        writer.Key("project_file");
+        writer.String(entry.m_project_file.c_str());
+        writer.Key("written");
+        writer.Bool(entry.m_success);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+
+    const bfs::path project_file_path(m_project_file_path);
+    const bfs::path manifest_path =
+        project_file_path.parent_path() / (project_file_path.stem().wstring() + L".manifest.json");
+    const std::string manifest_path_utf8 = wide_to_utf8(manifest_path.wstring());
+
+    std::ofstream file(manifest_path.wstring().c_str());
+    file << buffer.GetString();
+
+    if (!file)
+    {
+        RENDERER_LOG_ERROR("failed to write sequence manifest to %s.", manifest_path_utf8.c_str());
+        return;
+    }
+
+    const std::chrono::duration<double> export_time = Clock::now() - m_start_time;
+    const size_t written_count =
+        std::count_if(
+            m_manifest.begin(),
+            m_manifest.end(),
+            [](const ManifestEntry& entry) { return entry.m_success; });
+
+    RENDERER_LOG_INFO(
+        "exported %s project file%s in %s (%s frames per minute), wrote manifest to %s.",
+        asf::pretty_uint(written_count).c_str(),
+        written_count > 1 ? "s" : "",
+        asf::pretty_time(export_time.count()).c_str(),
+        asf::pretty_scalar(written_count * 60.0 / export_time.count(), 1).c_str(),
+        manifest_path_utf8.c_str());
+}
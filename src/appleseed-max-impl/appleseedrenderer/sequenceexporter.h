@@ -0,0 +1,111 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/utility/autoreleaseptr.h"
+
+// Standard headers.
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Forward declarations.
+namespace renderer  { class Project; }
+
+//
+// Writes the per-frame projects of an animation sequence to disk. Projects are built by
+// 3ds Max on the main thread and handed over to a pool of background threads that
+// serialize them while the next frames are being built. Each frame goes to its own
+// directory next to the project file set in the render settings, e.g.
+//
+//   C:\export\scene.appleseed  ->  C:\export\scene.0012\scene.0012.appleseed
+//
+// and a manifest listing every frame is written to C:\export\scene.manifest.json.
+//
+
+class SequenceProjectExporter
+  : public foundation::NonCopyable
+{
+  public:
+    SequenceProjectExporter(
+        const std::wstring&                             project_file_path,
+        const size_t                                    thread_count);
+
+    // Wait for the pending projects and write the manifest.
+    ~SequenceProjectExporter();
+
+    // Queue the project of a given frame for writing. Block while too many
+    // projects are already waiting so that memory usage remains bounded.
+    void write(
+        const int                                       frame,
+        foundation::auto_release_ptr<renderer::Project> project);
+
+  private:
+    struct Job
+    {
+        int                                             m_frame;
+        renderer::Project*                              m_project;
+    };
+
+    struct ManifestEntry
+    {
+        int                                             m_frame;
+        std::string                                     m_project_file;    // relative to the manifest
+        bool                                            m_success;
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    const std::wstring                                  m_project_file_path;
+    const size_t                                        m_max_pending_jobs;
+    const Clock::time_point                             m_start_time;
+
+    std::mutex                                          m_mutex;
+    std::condition_variable                             m_job_queued;
+    std::condition_variable                             m_job_taken;
+    std::deque<Job>                                     m_jobs;
+    bool                                                m_stopping;
+    std::vector<ManifestEntry>                          m_manifest;
+    std::vector<std::thread>                            m_threads;
+
+    void worker_thread();
+
+    ManifestEntry write_project(
+        const int                                       frame,
+        renderer::Project&                              project) const;
+
+    void write_manifest();
+};
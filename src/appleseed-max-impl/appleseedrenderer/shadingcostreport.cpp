@@ -0,0 +1,336 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "shadingcostreport.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/aov.h"
+#include "renderer/api/environment.h"
+#include "renderer/api/frame.h"
+#include "renderer/api/log.h"
+#include "renderer/api/material.h"
+#include "renderer/api/project.h"
+#include "renderer/api/rendering.h"
+#include "renderer/api/scene.h"
+#include "renderer/api/surfaceshader.h"
+#include "renderer/api/utility.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/math/aabb.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace asf = foundation;
+namespace asr = renderer;
+
+namespace
+{
+    const size_t MaxLoggedMaterials = 20;
+
+    struct MaterialRecord
+    {
+        asr::Assembly*          m_assembly;
+        asr::Material*          m_material;
+        std::string             m_surface_shader_name;      // original surface shader, may be empty
+        asr::SurfaceShader*     m_id_surface_shader;
+    };
+
+    struct MaterialCost
+    {
+        std::string             m_name;
+        double                  m_time;
+        size_t                  m_pixel_count;
+    };
+
+    void collect_materials(
+        asr::Assembly&                  assembly,
+        std::vector<MaterialRecord>&    records)
+    {
+        for (asr::Material& material : assembly.materials())
+        {
+            MaterialRecord record;
+            record.m_assembly = &assembly;
+            record.m_material = &material;
+            record.m_surface_shader_name =
+                material.get_parameters().get_optional<std::string>("surface_shader", "");
+            record.m_id_surface_shader = nullptr;
+            records.push_back(record);
+        }
+
+        for (asr::Assembly& child_assembly : assembly.assemblies())
+            collect_materials(child_assembly, records);
+    }
+
+    const asr::AOV* find_pixel_time_aov(const asr::Frame& frame)
+    {
+        for (const asr::AOV& aov : frame.aovs())
+        {
+            if (std::string(aov.get_model()) == "pixel_time_aov")
+                return &aov;
+        }
+
+        return nullptr;
+    }
+
+    // Make every material render as a constant color equal to its 1-based index.
+    void assign_id_surface_shaders(std::vector<MaterialRecord>& records)
+    {
+        for (size_t i = 0, e = records.size(); i < e; ++i)
+        {
+            MaterialRecord& record = records[i];
+
+            const std::string name =
+                asr::make_unique_name(
+                    record.m_assembly->surface_shaders(),
+                    std::string(record.m_material->get_name()) + "_shading_cost_id");
+
+            asf::auto_release_ptr<asr::SurfaceShader> surface_shader(
+                asr::ConstantSurfaceShaderFactory().create(
+                    name.c_str(),
+                    asr::ParamArray()
+                        .insert("color", static_cast<double>(i + 1))));
+
+            record.m_id_surface_shader = surface_shader.get();
+            record.m_assembly->surface_shaders().insert(surface_shader);
+            record.m_material->get_parameters().insert("surface_shader", name);
+        }
+    }
+
+    void restore_surface_shaders(std::vector<MaterialRecord>& records)
+    {
+        for (MaterialRecord& record : records)
+        {
+            if (record.m_surface_shader_name.empty())
+                record.m_material->get_parameters().strings().remove("surface_shader");
+            else record.m_material->get_parameters().insert("surface_shader", record.m_surface_shader_name);
+
+            record.m_assembly->surface_shaders().remove(record.m_id_surface_shader);
+        }
+    }
+
+    // Environment parameters removed for the ID pass, and their values.
+    typedef std::vector<std::pair<std::string, std::string>> EnvironmentBindings;
+
+    // Remove the environment shader and EDF so that the background renders with zero alpha
+    // and can't be mistaken for a material ID.
+    EnvironmentBindings disable_environment(asr::Scene& scene)
+    {
+        EnvironmentBindings bindings;
+
+        asr::Environment* environment = scene.get_environment();
+        if (environment == nullptr)
+            return bindings;
+
+        const char* Names[] = { "environment_edf", "environment_shader" };
+
+        asr::ParamArray& params = environment->get_parameters();
+        for (const char* name : Names)
+        {
+            const std::string value = params.get_optional<std::string>(name, "");
+            if (!value.empty())
+            {
+                bindings.push_back(std::make_pair(std::string(name), value));
+                params.strings().remove(name);
+            }
+        }
+
+        return bindings;
+    }
+
+    void restore_environment(asr::Scene& scene, const EnvironmentBindings& bindings)
+    {
+        asr::Environment* environment = scene.get_environment();
+        if (environment == nullptr)
+            return;
+
+        for (const auto& binding : bindings)
+            environment->get_parameters().insert(binding.first, binding.second);
+    }
+
+    // Replace the frame of the project by one suitable for rendering material IDs:
+    // a box filter restricted to the pixel footprint so that IDs don't get blended.
+    void setup_id_frame(asr::Project& project)
+    {
+        const asr::Frame* frame = project.get_frame();
+
+        asr::ParamArray params;
+        params.insert("camera", frame->get_parameters().get_optional<std::string>("camera", "camera"));
+        params.insert("resolution", frame->get_parameters().get_required<std::string>("resolution"));
+        params.insert("tile_size", frame->get_parameters().get_optional<std::string>("tile_size", "64 64"));
+        params.insert("filter", "box");
+        params.insert("filter_size", 0.5);
+
+        const asf::AABB2u crop_window = frame->get_crop_window();
+
+        asf::auto_release_ptr<asr::Frame> id_frame(asr::FrameFactory::create("beauty", params));
+        id_frame->set_crop_window(crop_window);
+        project.set_frame(id_frame);
+    }
+
+    void render_id_pass(asr::Project& project)
+    {
+        asr::ParamArray params =
+            project.configurations().get_by_name("final")->get_inherited_parameters();
+        params.insert_path("passes", 1);
+        params.insert_path("shading_result_framebuffer", "ephemeral");
+        params.insert_path("pixel_renderer", "uniform");
+        params.insert_path("uniform_pixel_renderer.samples", 1);
+        params.insert_path("uniform_pixel_renderer.force_antialiasing", false);
+        params.insert_path("generic_frame_renderer.tile_ordering", "linear");
+
+        asr::DefaultRendererController renderer_controller;
+        asr::MasterRenderer renderer(project, params, &renderer_controller);
+        renderer.render();
+    }
+}
+
+void report_shading_cost(asr::Project& project)
+{
+    const asr::Frame* frame = project.get_frame();
+    if (frame == nullptr)
+        return;
+
+    const asr::AOV* pixel_time_aov = find_pixel_time_aov(*frame);
+    if (pixel_time_aov == nullptr)
+    {
+        RENDERER_LOG_WARNING("shading cost report requires the pixel time aov, skipping.");
+        return;
+    }
+
+    // Copy pixel times before the frame gets replaced.
+    const asf::Image& time_image = pixel_time_aov->get_image();
+    const size_t width = time_image.properties().m_canvas_width;
+    const size_t height = time_image.properties().m_canvas_height;
+    std::vector<float> pixel_times(width * height);
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            float time[4];
+            time_image.get_pixel(x, y, time);
+            pixel_times[y * width + x] = time[0];
+        }
+    }
+
+    std::vector<MaterialRecord> records;
+    for (asr::Assembly& assembly : project.get_scene()->assemblies())
+        collect_materials(assembly, records);
+
+    if (records.empty())
+        return;
+
+    asr::Scene& scene = *project.get_scene();
+    const EnvironmentBindings environment_bindings = disable_environment(scene);
+    assign_id_surface_shaders(records);
+    setup_id_frame(project);
+    render_id_pass(project);
+    restore_surface_shaders(records);
+    restore_environment(scene, environment_bindings);
+
+    // Accumulate pixel times per material name.
+    std::map<std::string, MaterialCost> costs;
+    double total_time = 0.0;
+    double background_time = 0.0;
+
+    const asf::Image& id_image = project.get_frame()->image();
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            const float pixel_time = pixel_times[y * width + x];
+            total_time += pixel_time;
+
+            float id[4];
+            id_image.get_pixel(x, y, id);
+
+            // Colors are premultiplied by alpha.
+            const size_t index =
+                id[3] > 0.0f ? static_cast<size_t>(id[0] / id[3] + 0.5f) : 0;
+
+            if (index == 0 || index > records.size())
+            {
+                background_time += pixel_time;
+                continue;
+            }
+
+            const std::string name = records[index - 1].m_material->get_name();
+            MaterialCost& cost = costs[name];
+            cost.m_name = name;
+            cost.m_time += pixel_time;
+            ++cost.m_pixel_count;
+        }
+    }
+
+    std::vector<MaterialCost> sorted_costs;
+    for (const auto& entry : costs)
+        sorted_costs.push_back(entry.second);
+
+    std::sort(
+        sorted_costs.begin(),
+        sorted_costs.end(),
+        [](const MaterialCost& lhs, const MaterialCost& rhs)
+        {
+            return lhs.m_time > rhs.m_time;
+        });
+
+    const auto percent = [total_time](const double t)
+    {
+        return total_time > 0.0 ? 100.0 * t / total_time : 0.0;
+    };
+
+    RENDERER_LOG_INFO(
+        "shading cost by material (%s material%s, %s in total, %s on background):",
+        asf::pretty_uint(sorted_costs.size()).c_str(),
+        sorted_costs.size() > 1 ? "s" : "",
+        asf::pretty_time(total_time).c_str(),
+        asf::pretty_time(background_time).c_str());
+
+    const size_t logged_materials = std::min(sorted_costs.size(), MaxLoggedMaterials);
+    for (size_t i = 0; i < logged_materials; ++i)
+    {
+        const MaterialCost& cost = sorted_costs[i];
+        RENDERER_LOG_INFO(
+            "  %-40s %10s  %5.1f%%  %s pixel%s",
+            cost.m_name.c_str(),
+            asf::pretty_time(cost.m_time).c_str(),
+            percent(cost.m_time),
+            asf::pretty_uint(cost.m_pixel_count).c_str(),
+            cost.m_pixel_count > 1 ? "s" : "");
+    }
+}
@@ -0,0 +1,118 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Interface header.
+#include "texturesystem.h"
+
+// appleseed-max headers.
+#include "appleseedrenderer/renderersettings.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/log.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/types.h"
+#include "foundation/utility/string.h"
+
+// OpenImageIO headers.
+#include "OpenImageIO/imagecache.h"
+#include "OpenImageIO/typedesc.h"
+
+namespace asf = foundation;
+
+namespace
+{
+    OIIO::ImageCache* get_shared_image_cache()
+    {
+        // All callers get the same cache, which lives until the process exits.
+        return OIIO::ImageCache::create(true);
+    }
+}
+
+void configure_texture_system(const RendererSettings& settings)
+{
+    OIIO::ImageCache* image_cache = get_shared_image_cache();
+
+    image_cache->attribute("max_memory_MB", static_cast<float>(settings.m_osl_texture_cache_size));
+    image_cache->attribute("max_open_files", settings.m_osl_texture_max_open_files);
+    image_cache->attribute("automip", settings.m_osl_texture_automip ? 1 : 0);
+
+    image_cache->reset_stats();
+}
+
+TextureSystemStatistics::TextureSystemStatistics()
+  : m_tile_lookups(0)
+  , m_tile_hits(0)
+  , m_bytes_read(0)
+  , m_files_opened(0)
+  , m_fileio_time(0.0)
+{
+}
+
+bool get_texture_system_statistics(TextureSystemStatistics& statistics)
+{
+    OIIO::ImageCache* image_cache = get_shared_image_cache();
+
+    long long tile_lookups = 0;
+    long long tile_misses = 0;
+    long long bytes_read = 0;
+    int files_opened = 0;
+    float fileio_time = 0.0f;
+    if (!image_cache->getattribute("stat:find_tile_calls", OIIO::TypeDesc::INT64, &tile_lookups) ||
+        !image_cache->getattribute("stat:find_tile_cache_misses", OIIO::TypeDesc::INT64, &tile_misses) ||
+        !image_cache->getattribute("stat:bytes_read", OIIO::TypeDesc::INT64, &bytes_read) ||
+        !image_cache->getattribute("stat:open_files_created", files_opened) ||
+        !image_cache->getattribute("stat:fileio_time", fileio_time))
+        return false;
+
+    statistics.m_tile_lookups = static_cast<asf::uint64>(tile_lookups);
+    statistics.m_tile_hits = static_cast<asf::uint64>(tile_lookups - tile_misses);
+    statistics.m_bytes_read = static_cast<asf::uint64>(bytes_read);
+    statistics.m_files_opened = static_cast<asf::uint64>(files_opened);
+    statistics.m_fileio_time = fileio_time;
+
+    return true;
+}
+
+void report_texture_system_statistics()
+{
+    TextureSystemStatistics statistics;
+    if (!get_texture_system_statistics(statistics) || statistics.m_tile_lookups == 0)
+        return;
+
+    RENDERER_LOG_INFO(
+        "osl textures: %s tile lookup%s, %s cache hit%s (%s), %s read from %s file open%s in %s.",
+        asf::pretty_uint(statistics.m_tile_lookups).c_str(),
+        statistics.m_tile_lookups > 1 ? "s" : "",
+        asf::pretty_uint(statistics.m_tile_hits).c_str(),
+        statistics.m_tile_hits > 1 ? "s" : "",
+        asf::pretty_percent(statistics.m_tile_hits, statistics.m_tile_lookups).c_str(),
+        asf::pretty_size(statistics.m_bytes_read).c_str(),
+        asf::pretty_uint(statistics.m_files_opened).c_str(),
+        statistics.m_files_opened > 1 ? "s" : "",
+        asf::pretty_time(statistics.m_fileio_time).c_str());
+}
@@ -0,0 +1,56 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2018 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/platform/types.h"
+
+// Forward declarations.
+class RendererSettings;
+
+// Statistics of OpenImageIO's shared image cache since it was last configured.
+struct TextureSystemStatistics
+{
+    foundation::uint64  m_tile_lookups;
+    foundation::uint64  m_tile_hits;
+    foundation::uint64  m_bytes_read;
+    foundation::uint64  m_files_opened;
+    double              m_fileio_time;      // in seconds
+
+    TextureSystemStatistics();
+};
+
+// Apply the OSL texture settings of `settings` to OpenImageIO's shared image cache,
+// through which OSL shaders read texture files, and reset its statistics.
+void configure_texture_system(const RendererSettings& settings);
+
+// Retrieve the statistics of OpenImageIO's shared image cache. Return false if they are unavailable.
+bool get_texture_system_statistics(TextureSystemStatistics& statistics);
+
+// Log the hit rate and file I/O of OpenImageIO's shared image cache since it was configured.
+void report_texture_system_statistics();
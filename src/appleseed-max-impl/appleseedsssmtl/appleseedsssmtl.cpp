@@ -110,7 +110,9 @@ namespace
         ParamIdBumpMethod                   = 15,
         ParamIdBumpTexmap                   = 16,
         ParamIdBumpAmount                   = 17,
-        ParamIdBumpUpVector                 = 18
+        ParamIdBumpUpVector                 = 18,
+        ParamIdAlpha                        = 19,
+        ParamIdAlphaTexmap                  = 20
     };
 
     enum TexmapId
@@ -123,6 +125,7 @@ namespace
         TexmapIdSpecularRoughness           = 4,
         TexmapIdSpecularAnisotropy          = 5,
         TexmapIdBumpMap                     = 6,
+        TexmapIdAlpha                       = 7,
         TexmapCount                         // keep last
     };
 
@@ -134,7 +137,8 @@ namespace
         L"Specular Amount",
         L"Specular Roughness",
         L"Specular Anisotropy",
-        L"Bump Map"
+        L"Bump Map",
+        L"Alpha"
     };
 
     const ParamId g_texmap_id_to_param_id[TexmapCount] =
@@ -145,7 +149,8 @@ namespace
         ParamIdSpecularAmountTexmap,
         ParamIdSpecularRoughnessTexmap,
         ParamIdSpecularAnisotropyTexmap,
-        ParamIdBumpTexmap
+        ParamIdBumpTexmap,
+        ParamIdAlphaTexmap
     };
 
     ParamBlockDesc2 g_block_desc(
@@ -224,6 +229,16 @@ namespace
             p_ui, ParamMapIdSSS, TYPE_SLIDER, EDITTYPE_FLOAT, IDC_EDIT_SSS_IOR, IDC_SLIDER_SSS_IOR, 0.1f,
         p_end,
 
+        ParamIdAlpha, L"alpha", TYPE_FLOAT, P_ANIMATABLE, IDS_ALPHA,
+            p_default, 100.0f,
+            p_range, 0.0f, 100.0f,
+            p_ui, ParamMapIdSSS, TYPE_SLIDER, EDITTYPE_FLOAT, IDC_EDIT_ALPHA, IDC_SLIDER_ALPHA, 10.0f,
+        p_end,
+        ParamIdAlphaTexmap, L"alpha_texmap", TYPE_TEXMAP, P_NO_AUTO_LABELS, IDS_TEXMAP_ALPHA,
+            p_subtexno, TexmapIdAlpha,
+            p_ui, ParamMapIdSSS, TYPE_TEXMAPBUTTON, IDC_TEXMAP_ALPHA,
+        p_end,
+
         // --- Parameters specifications for Specular rollup ---
 
         ParamIdSpecularColor, L"specular_color", TYPE_RGBA, P_ANIMATABLE, IDS_SPECULAR_COLOR,
@@ -310,6 +325,8 @@ AppleseedSSSMtl::AppleseedSSSMtl()
   , m_sss_amount(100.0f)
   , m_sss_scale(1.0f)
   , m_sss_ior(1.3f)
+  , m_alpha(100.0f)
+  , m_alpha_texmap(nullptr)
   , m_specular_color(0.9f, 0.9f, 0.9f)
   , m_specular_color_texmap(nullptr)
   , m_specular_amount(100.0f)
@@ -461,7 +478,7 @@ void AppleseedSSSMtl::SetSubTexmap(int i, Texmap* texmap)
     const auto param_id = g_texmap_id_to_param_id[texmap_id];
     m_pblock->SetValue(param_id, 0, texmap);
 
-    IParamMap2* map = m_pblock->GetMap(ParamMapIdSpecular);
+    IParamMap2* map = m_pblock->GetMap(texmap_id == TexmapIdAlpha ? ParamMapIdSSS : ParamMapIdSpecular);
     if (map != nullptr)
     {
         map->SetText(param_id, texmap == nullptr ? L"" : L"M");
@@ -495,6 +512,9 @@ void AppleseedSSSMtl::Update(TimeValue t, Interval& valid)
         m_pblock->GetValue(ParamIdSSSScale, t, m_sss_scale, m_params_validity);
         m_pblock->GetValue(ParamIdSSSIOR, t, m_sss_ior, m_params_validity);
 
+        m_pblock->GetValue(ParamIdAlpha, t, m_alpha, m_params_validity);
+        m_pblock->GetValue(ParamIdAlphaTexmap, t, m_alpha_texmap, m_params_validity);
+
         m_pblock->GetValue(ParamIdSpecularColor, t, m_specular_color, m_params_validity);
         m_pblock->GetValue(ParamIdSpecularColorTexmap, t, m_specular_color_texmap, m_params_validity);
 
@@ -536,6 +556,7 @@ ParamDlg* AppleseedSSSMtl::CreateParamDlg(HWND hwMtlEdit, IMtlParams* imp)
 {
     ParamDlg* param_dialog = g_appleseed_sssmtl_classdesc.CreateParamDlgs(hwMtlEdit, imp, this);
     DbgAssert(m_pblock != nullptr);
+    update_map_buttons(m_pblock->GetMap(ParamMapIdSSS));
     update_map_buttons(m_pblock->GetMap(ParamMapIdSpecular));
     g_block_desc.SetUserDlgProc(ParamMapIdBump, new BumpParamMapDlgProc());
     return param_dialog;
@@ -705,19 +726,19 @@ asf::auto_release_ptr<asr::Material> AppleseedSSSMtl::create_osl_material(
 
     shader_group->add_shader("surface", "as_max_sss_material", name, 
         asr::ParamArray()
-            .insert("Radius", fmt_osl_expr(to_color3f(m_sss_scattering_color)))
-            .insert("SSSColor", fmt_osl_expr(to_color3f(m_sss_color)))
-            .insert("SpecularColor", fmt_osl_expr(to_color3f(m_specular_color)))
-            .insert("SpecularReflectance", fmt_osl_expr(m_specular_amount / 100.0f))
-            .insert("Roughness", fmt_osl_expr(m_specular_roughness / 100.0f))
-            .insert("Anisotropic", fmt_osl_expr(m_specular_anisotropy / 100.0f))
+            .insert("Radius", fmt_osl_expr(fold_color_texture(m_sss_scattering_color_texmap, m_sss_scattering_color, time)))
+            .insert("SSSColor", fmt_osl_expr(fold_color_texture(m_sss_color_texmap, m_sss_color, time)))
+            .insert("SpecularColor", fmt_osl_expr(fold_color_texture(m_specular_color_texmap, m_specular_color, time)))
+            .insert("SpecularReflectance", fmt_osl_expr(fold_float_texture(m_specular_amount_texmap, m_specular_amount / 100.0f, time)))
+            .insert("Roughness", fmt_osl_expr(fold_float_texture(m_specular_roughness_texmap, m_specular_roughness / 100.0f, time)))
+            .insert("Anisotropic", fmt_osl_expr(fold_float_texture(m_specular_anisotropy_texmap, m_specular_anisotropy / 100.0f, time)))
             .insert("RadiusScale", fmt_osl_expr(m_sss_scale))
             .insert("Profile", fmt_osl_expr("normalized_diffusion"))
             .insert("SSSReflectance", fmt_osl_expr(m_sss_amount / 100.0f))
             .insert("Distribution", fmt_osl_expr("ggx"))
             .insert("Ior", fmt_osl_expr(m_sss_ior)));
 
-    std::string closure2surface_name = asf::format("{0}_closure2surface", name);
+    std::string closure2surface_name = LayerNames(name).get("closure2surface");
     shader_group.ref().add_shader("shader", "as_max_closure2surface", closure2surface_name.c_str(), asr::ParamArray());
 
     shader_group.ref().add_connection(
@@ -735,6 +756,16 @@ asf::auto_release_ptr<asr::Material> AppleseedSSSMtl::create_osl_material(
     asr::ParamArray material_params;
     material_params.insert("osl_surface", shader_group_name);
 
+    const std::string instance_name =
+        insert_cutout_texture_and_instance(
+            assembly,
+            m_alpha_texmap,
+            false,
+            time);
+    if (!instance_name.empty())
+        material_params.insert("alpha_map", instance_name);
+    else material_params.insert("alpha_map", m_alpha / 100.0f);
+
     return asr::OSLMaterialFactory().create(name, material_params);
 }
 
@@ -836,6 +867,16 @@ asf::auto_release_ptr<asr::Material> AppleseedSSSMtl::create_builtin_material(
     // Material.
     //
 
+    // Alpha map.
+    instance_name = insert_cutout_texture_and_instance(
+        assembly,
+        m_alpha_texmap,
+        use_max_procedural_maps,
+        time);
+    if (!instance_name.empty())
+        material_params.insert("alpha_map", instance_name);
+    else material_params.insert("alpha_map", m_alpha / 100.0f);
+
     // Displacement.
     instance_name = insert_texture_and_instance(
         assembly,
@@ -154,6 +154,8 @@ private:
     float           m_sss_amount;
     float           m_sss_scale;
     float           m_sss_ior;
+    float           m_alpha;
+    Texmap*         m_alpha_texmap;
     Color           m_specular_color;
     Texmap*         m_specular_color_texmap;
     float           m_specular_amount;
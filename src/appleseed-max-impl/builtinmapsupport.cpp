@@ -38,12 +38,302 @@
 #include "renderer/api/shadergroup.h"
 #include "renderer/api/utility.h"
 
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+
 // 3ds Max Headers.
+#include <iparamb2.h>
 #include <imtl.h>
+#include <stdmat.h>
+
+// Standard headers.
+#include <cstring>
+#include <string>
 
 namespace asf = foundation;
 namespace asr = renderer;
 
+namespace
+{
+    //
+    // OSL equivalents of the most common 3ds Max procedural maps.
+    //
+    // They are embedded as source code and compiled by appleseed when the shader group is set up,
+    // so that these maps are shaded on all render threads without calling back into 3ds Max.
+    // Parameters are read from the maps' parameter blocks at export time.
+    //
+
+    const char* MaxNoiseFunctionSource =
+        "float as_max_noise(point p, float phase, int type, float levels)\n"
+        "{\n"
+        "    if (type == 0)\n"
+        "        return 0.5 + 0.5 * noise(\"perlin\", p, phase);\n"
+        "\n"
+        "    float result = 0.0;\n"
+        "    float scale = 1.0;\n"
+        "    float remaining = levels;\n"
+        "\n"
+        "    for (int i = 0; i < 10 && remaining > 0.0; ++i)\n"
+        "    {\n"
+        "        float n = noise(\"perlin\", p * scale, phase);\n"
+        "        result += min(remaining, 1.0) * (type == 2 ? abs(n) : n) / scale;\n"
+        "        scale *= 2.0;\n"
+        "        remaining -= 1.0;\n"
+        "    }\n"
+        "\n"
+        "    return type == 2 ? result : 0.5 + 0.5 * result;\n"
+        "}\n";
+
+    const char* MaxCheckerMapSource =
+        "float as_max_checker_side(float x, float width)\n"
+        "{\n"
+        "    float s = 2.0 * (x - floor(x));\n"
+        "    float d = s < 1.0 ? min(s, 1.0 - s) : -min(s - 1.0, 2.0 - s);\n"
+        "    return width > 0.0 ? clamp(d / width, -1.0, 1.0) : (d < 0.0 ? -1.0 : 1.0);\n"
+        "}\n"
+        "\n"
+        "shader as_max_checker_map(\n"
+        "    float U = 0.0,\n"
+        "    float V = 0.0,\n"
+        "    color in_color1 = color(0.0),\n"
+        "    color in_color2 = color(1.0),\n"
+        "    float in_soften = 0.0,\n"
+        "    output color out_outColor = color(0.0),\n"
+        "    output float out_outFloat = 0.0)\n"
+        "{\n"
+        "    float k = 0.5 - 0.5 * as_max_checker_side(U, in_soften) * as_max_checker_side(V, in_soften);\n"
+        "    out_outColor = mix(in_color1, in_color2, k);\n"
+        "    out_outFloat = (out_outColor[0] + out_outColor[1] + out_outColor[2]) / 3.0;\n"
+        "}\n";
+
+    const char* MaxGradientMapSource =
+        "shader as_max_gradient_map(\n"
+        "    float U = 0.0,\n"
+        "    float V = 0.0,\n"
+        "    color in_color1 = color(0.0),\n"
+        "    color in_color2 = color(0.5),\n"
+        "    color in_color3 = color(1.0),\n"
+        "    float in_color2Pos = 0.5,\n"
+        "    int in_gradientType = 0,\n"
+        "    float in_noiseAmount = 0.0,\n"
+        "    int in_noiseType = 0,\n"
+        "    float in_noiseSize = 1.0,\n"
+        "    float in_noisePhase = 0.0,\n"
+        "    float in_noiseLevels = 4.0,\n"
+        "    output color out_outColor = color(0.0),\n"
+        "    output float out_outFloat = 0.0)\n"
+        "{\n"
+        "    float u = U - floor(U);\n"
+        "    float v = V - floor(V);\n"
+        "    float t = in_gradientType == 1 ? 1.0 - 2.0 * hypot(u - 0.5, v - 0.5) : v;\n"
+        "\n"
+        "    if (in_noiseAmount > 0.0)\n"
+        "    {\n"
+        "        point p = point(u, v, 0.0) / max(in_noiseSize, 1.0e-4);\n"
+        "        t += in_noiseAmount * (2.0 * as_max_noise(p, in_noisePhase, in_noiseType, in_noiseLevels) - 1.0);\n"
+        "    }\n"
+        "\n"
+        "    t = clamp(t, 0.0, 1.0);\n"
+        "\n"
+        "    float pos = clamp(in_color2Pos, 1.0e-4, 1.0 - 1.0e-4);\n"
+        "    out_outColor =\n"
+        "        t < pos\n"
+        "            ? mix(in_color3, in_color2, t / pos)\n"
+        "            : mix(in_color2, in_color1, (t - pos) / (1.0 - pos));\n"
+        "    out_outFloat = (out_outColor[0] + out_outColor[1] + out_outColor[2]) / 3.0;\n"
+        "}\n";
+
+    const char* MaxNoiseMapSource =
+        "shader as_max_noise_map(\n"
+        "    int in_coordSystem = 0,\n"
+        "    vector in_offset = vector(0.0),\n"
+        "    vector in_tiling = vector(1.0),\n"
+        "    vector in_angle = vector(0.0),\n"
+        "    color in_color1 = color(0.0),\n"
+        "    color in_color2 = color(1.0),\n"
+        "    float in_size = 25.0,\n"
+        "    float in_phase = 0.0,\n"
+        "    int in_type = 0,\n"
+        "    float in_levels = 3.0,\n"
+        "    float in_thresholdLow = 0.0,\n"
+        "    float in_thresholdHigh = 1.0,\n"
+        "    output color out_outColor = color(0.0),\n"
+        "    output float out_outFloat = 0.0)\n"
+        "{\n"
+        "    point p =\n"
+        "        in_coordSystem == 3 ? P :\n"
+        "        in_coordSystem == 0 ? transform(\"object\", P) :\n"
+        "        point(u, v, 0.0);\n"
+        "\n"
+        "    p = (p + in_offset) * in_tiling;\n"
+        "    p = rotate(p, in_angle[0], vector(1.0, 0.0, 0.0));\n"
+        "    p = rotate(p, in_angle[1], vector(0.0, 1.0, 0.0));\n"
+        "    p = rotate(p, in_angle[2], vector(0.0, 0.0, 1.0));\n"
+        "\n"
+        "    float n = as_max_noise(p / max(in_size, 1.0e-4), in_phase, in_type, in_levels);\n"
+        "\n"
+        "    if (in_thresholdHigh > in_thresholdLow)\n"
+        "        n = (n - in_thresholdLow) / (in_thresholdHigh - in_thresholdLow);\n"
+        "\n"
+        "    out_outColor = mix(in_color1, in_color2, clamp(n, 0.0, 1.0));\n"
+        "    out_outFloat = (out_outColor[0] + out_outColor[1] + out_outColor[2]) / 3.0;\n"
+        "}\n";
+
+    template <typename T>
+    T get_map_param(IParamBlock2* pblock, const wchar_t* name, const TimeValue time, const T default_value)
+    {
+        T value = default_value;
+        pblock->GetValueByName(name, time, value, FOREVER);
+        return value;
+    }
+
+    // Connect the sub-map of a color slot; return the value the slot's parameter should have.
+    asf::Color3f connect_sub_map(
+        asr::ShaderGroup&   shader_group,
+        const char*         layer_name,
+        const char*         layer_input_name,
+        Texmap*             texmap,
+        const wchar_t*      map_name,
+        const wchar_t*      map_enabled_name,
+        const Color&        const_color,
+        const TimeValue     time)
+    {
+        IParamBlock2* pblock = texmap->GetParamBlock(0);
+
+        Texmap* sub_map = get_map_param<Texmap*>(pblock, map_name, time, nullptr);
+        const int sub_map_enabled = get_map_param(pblock, map_enabled_name, time, TRUE);
+
+        if (sub_map == nullptr || !sub_map_enabled)
+            return to_color3f(const_color);
+
+        connect_color_texture(
+            shader_group,
+            layer_name,
+            layer_input_name,
+            sub_map,
+            const_color,
+            time);
+
+        return fold_color_texture(sub_map, const_color, time);
+    }
+
+    // Get the value of a color slot if it is constant, taking its sub-map into account.
+    bool get_constant_slot_value(
+        IParamBlock2*       pblock,
+        const wchar_t*      color_name,
+        const wchar_t*      map_name,
+        const wchar_t*      map_enabled_name,
+        const TimeValue     time,
+        AColor&             value)
+    {
+        Texmap* sub_map = get_map_param<Texmap*>(pblock, map_name, time, nullptr);
+        const int sub_map_enabled = get_map_param(pblock, map_enabled_name, time, TRUE);
+
+        if (sub_map != nullptr && sub_map_enabled)
+            return get_constant_map_value(sub_map, time, value);
+
+        value = AColor(get_map_param(pblock, color_name, time, Color(0.0f, 0.0f, 0.0f)));
+        return true;
+    }
+
+    TextureOutput* find_texture_output(Texmap* texmap)
+    {
+        for (int i = 0, e = texmap->NumRefs(); i < e; ++i)
+        {
+            ReferenceTarget* ref = texmap->GetReference(i);
+            if (ref != nullptr && ref->SuperClassID() == TEXOUTPUT_CLASS_ID)
+                return static_cast<TextureOutput*>(ref);
+        }
+
+        return nullptr;
+    }
+
+    AColor apply_texture_output(Texmap* texmap, const AColor& value)
+    {
+        TextureOutput* output = find_texture_output(texmap);
+        return output != nullptr ? output->Filter(value) : value;
+    }
+
+    // Return true if the Output rollout of a map maps every input value to the same output.
+    bool has_flat_texture_output(Texmap* texmap, const TimeValue time)
+    {
+        StdTexoutGen* output = dynamic_cast<StdTexoutGen*>(find_texture_output(texmap));
+        if (output == nullptr)
+            return false;
+
+        if (output->GetOutAmt(time) == 0.0f)
+            return true;
+
+        // Without a color map curve, the output is an affine function of the input.
+        return !output->GetFlag(TEXOUT_COLOR_MAP) && output->GetRGBAmt(time) == 0.0f;
+    }
+
+    void connect_uv_transform(
+        asr::ShaderGroup&   shader_group,
+        const char*         layer_name,
+        Texmap*             texmap,
+        const TimeValue     time)
+    {
+        const auto uv_transform_layer_name = LayerNames(layer_name).get("uv_transform");
+        shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
+
+        shader_group.add_connection(
+            uv_transform_layer_name.c_str(), "out_U",
+            layer_name, "U");
+
+        shader_group.add_connection(
+            uv_transform_layer_name.c_str(), "out_V",
+            layer_name, "V");
+    }
+
+    // Apply the map's Output rollout to the output of a map layer, as the bitmap path does.
+    void connect_texture_output(
+        asr::ShaderGroup&   shader_group,
+        const char*         material_node_name,
+        const char*         material_input_name,
+        Texmap*             texmap,
+        const char*         layer_name,
+        const char*         output_name,
+        const TimeValue     time)
+    {
+        const bool is_float = strcmp(output_name, "out_outFloat") == 0;
+        const auto color_balance_layer_name = LayerNames(material_node_name, material_input_name).get("color_balance");
+
+        shader_group.add_shader("shader", "as_max_color_balance", color_balance_layer_name.c_str(), get_output_params(texmap, time));
+
+        shader_group.add_connection(
+            layer_name, output_name,
+            color_balance_layer_name.c_str(), is_float ? "in_defaultFloat" : "in_defaultColor");
+
+        shader_group.add_connection(
+            color_balance_layer_name.c_str(), is_float ? "out_outAlpha" : "out_outColor",
+            material_node_name, material_input_name);
+    }
+
+    // Read the coordinates rollout of a 3D map.
+    asr::ParamArray get_xyz_params(Texmap* texmap, const TimeValue time)
+    {
+        asr::ParamArray params;
+
+        XYZGen* xyz_gen = texmap->GetTheXYZGen();
+        if (!xyz_gen || !xyz_gen->IsStdXYZGen())
+            return params;
+
+        StdXYZGen* std_xyz = static_cast<StdXYZGen*>(xyz_gen);
+
+        const asf::Vector3f offset(std_xyz->GetOffs(0, time), std_xyz->GetOffs(1, time), std_xyz->GetOffs(2, time));
+        const asf::Vector3f tiling(std_xyz->GetScl(0, time), std_xyz->GetScl(1, time), std_xyz->GetScl(2, time));
+        const asf::Vector3f angle(std_xyz->GetAng(0, time), std_xyz->GetAng(1, time), std_xyz->GetAng(2, time));
+
+        params.insert("in_coordSystem", fmt_osl_expr(std_xyz->GetCoordSystem()));
+        params.insert("in_offset", fmt_osl_expr(offset));
+        params.insert("in_tiling", fmt_osl_expr(tiling));
+        params.insert("in_angle", fmt_osl_expr(angle));
+
+        return params;
+    }
+}
+
 void connect_output_selector(
     asr::ShaderGroup&   shader_group,
     const char*         material_node_name,
@@ -81,7 +371,7 @@ void connect_output_map(
     const Color         const_value,
     const TimeValue     time)
 {
-    auto color_balance_layer_name = foundation::format("{0}_{1}_color_balance", material_node_name, material_input_name);
+    auto color_balance_layer_name = LayerNames(material_node_name, material_input_name).get("color_balance");
 
     Texmap* input_map = nullptr;
     texmap->GetParamBlock(0)->GetValueByName(L"map1", time, input_map, FOREVER);
@@ -112,7 +402,7 @@ void connect_output_map(
     const float         const_value,
     const TimeValue     time)
 {
-    auto color_balance_layer_name = foundation::format("{0}_{1}_color_balance", material_node_name, material_input_name);
+    auto color_balance_layer_name = LayerNames(material_node_name, material_input_name).get("color_balance");
 
     Texmap* input_map = nullptr;
     texmap->GetParamBlock(0)->GetValueByName(L"map1", time, input_map, FOREVER);
@@ -134,3 +424,252 @@ void connect_output_map(
         color_balance_layer_name.c_str(), "out_outAlpha",
         material_node_name, material_input_name);
 }
+
+void connect_checker_map(
+    asr::ShaderGroup&   shader_group,
+    const char*         material_node_name,
+    const char*         material_input_name,
+    Texmap*             texmap,
+    const char*         output_name,
+    const TimeValue     time)
+{
+    const auto layer_name = LayerNames(material_node_name, material_input_name).get("checker");
+    IParamBlock2* pblock = texmap->GetParamBlock(0);
+
+    const Color color1 = get_map_param(pblock, L"color1", time, Color(0.0f, 0.0f, 0.0f));
+    const Color color2 = get_map_param(pblock, L"color2", time, Color(1.0f, 1.0f, 1.0f));
+
+    const asf::Color3f value1 = connect_sub_map(shader_group, layer_name.c_str(), "in_color1", texmap, L"map1", L"map1Enabled", color1, time);
+    const asf::Color3f value2 = connect_sub_map(shader_group, layer_name.c_str(), "in_color2", texmap, L"map2", L"map2Enabled", color2, time);
+
+    connect_uv_transform(shader_group, layer_name.c_str(), texmap, time);
+
+    shader_group.add_source_shader("shader", "as_max_checker_map", layer_name.c_str(), MaxCheckerMapSource,
+        asr::ParamArray()
+            .insert("in_color1", fmt_osl_expr(value1))
+            .insert("in_color2", fmt_osl_expr(value2))
+            .insert("in_soften", fmt_osl_expr(get_map_param(pblock, L"soften", time, 0.0f))));
+
+    connect_texture_output(
+        shader_group,
+        material_node_name,
+        material_input_name,
+        texmap,
+        layer_name.c_str(),
+        output_name,
+        time);
+}
+
+void connect_gradient_map(
+    asr::ShaderGroup&   shader_group,
+    const char*         material_node_name,
+    const char*         material_input_name,
+    Texmap*             texmap,
+    const char*         output_name,
+    const TimeValue     time)
+{
+    const auto layer_name = LayerNames(material_node_name, material_input_name).get("gradient");
+    IParamBlock2* pblock = texmap->GetParamBlock(0);
+
+    const Color color1 = get_map_param(pblock, L"color1", time, Color(0.0f, 0.0f, 0.0f));
+    const Color color2 = get_map_param(pblock, L"color2", time, Color(0.5f, 0.5f, 0.5f));
+    const Color color3 = get_map_param(pblock, L"color3", time, Color(1.0f, 1.0f, 1.0f));
+
+    const asf::Color3f value1 = connect_sub_map(shader_group, layer_name.c_str(), "in_color1", texmap, L"map1", L"map1Enabled", color1, time);
+    const asf::Color3f value2 = connect_sub_map(shader_group, layer_name.c_str(), "in_color2", texmap, L"map2", L"map2Enabled", color2, time);
+    const asf::Color3f value3 = connect_sub_map(shader_group, layer_name.c_str(), "in_color3", texmap, L"map3", L"map3Enabled", color3, time);
+
+    connect_uv_transform(shader_group, layer_name.c_str(), texmap, time);
+
+    const std::string source = std::string(MaxNoiseFunctionSource) + MaxGradientMapSource;
+
+    shader_group.add_source_shader("shader", "as_max_gradient_map", layer_name.c_str(), source.c_str(),
+        asr::ParamArray()
+            .insert("in_color1", fmt_osl_expr(value1))
+            .insert("in_color2", fmt_osl_expr(value2))
+            .insert("in_color3", fmt_osl_expr(value3))
+            .insert("in_color2Pos", fmt_osl_expr(get_map_param(pblock, L"color2Pos", time, 0.5f)))
+            .insert("in_gradientType", fmt_osl_expr(get_map_param(pblock, L"gradientType", time, 0)))
+            .insert("in_noiseAmount", fmt_osl_expr(get_map_param(pblock, L"noiseAmount", time, 0.0f)))
+            .insert("in_noiseType", fmt_osl_expr(get_map_param(pblock, L"noiseType", time, 0)))
+            .insert("in_noiseSize", fmt_osl_expr(get_map_param(pblock, L"noiseSize", time, 1.0f)))
+            .insert("in_noisePhase", fmt_osl_expr(get_map_param(pblock, L"noisePhase", time, 0.0f)))
+            .insert("in_noiseLevels", fmt_osl_expr(get_map_param(pblock, L"noiseLevels", time, 4.0f))));
+
+    connect_texture_output(
+        shader_group,
+        material_node_name,
+        material_input_name,
+        texmap,
+        layer_name.c_str(),
+        output_name,
+        time);
+}
+
+void connect_noise_map(
+    asr::ShaderGroup&   shader_group,
+    const char*         material_node_name,
+    const char*         material_input_name,
+    Texmap*             texmap,
+    const char*         output_name,
+    const TimeValue     time)
+{
+    const auto layer_name = LayerNames(material_node_name, material_input_name).get("noise");
+    IParamBlock2* pblock = texmap->GetParamBlock(0);
+
+    const Color color1 = get_map_param(pblock, L"color1", time, Color(0.0f, 0.0f, 0.0f));
+    const Color color2 = get_map_param(pblock, L"color2", time, Color(1.0f, 1.0f, 1.0f));
+
+    const asf::Color3f value1 = connect_sub_map(shader_group, layer_name.c_str(), "in_color1", texmap, L"map1", L"map1On", color1, time);
+    const asf::Color3f value2 = connect_sub_map(shader_group, layer_name.c_str(), "in_color2", texmap, L"map2", L"map2On", color2, time);
+
+    // Noise is a 3D map: it's evaluated through its coordinates rollout rather than a UV transform.
+    const std::string source = std::string(MaxNoiseFunctionSource) + MaxNoiseMapSource;
+
+    shader_group.add_source_shader("shader", "as_max_noise_map", layer_name.c_str(), source.c_str(),
+        get_xyz_params(texmap, time)
+            .insert("in_color1", fmt_osl_expr(value1))
+            .insert("in_color2", fmt_osl_expr(value2))
+            .insert("in_size", fmt_osl_expr(get_map_param(pblock, L"size", time, 25.0f)))
+            .insert("in_phase", fmt_osl_expr(get_map_param(pblock, L"phase", time, 0.0f)))
+            .insert("in_type", fmt_osl_expr(get_map_param(pblock, L"type", time, 0)))
+            .insert("in_levels", fmt_osl_expr(get_map_param(pblock, L"levels", time, 3.0f)))
+            .insert("in_thresholdLow", fmt_osl_expr(get_map_param(pblock, L"thresholdLow", time, 0.0f)))
+            .insert("in_thresholdHigh", fmt_osl_expr(get_map_param(pblock, L"thresholdHigh", time, 1.0f))));
+
+    connect_texture_output(
+        shader_group,
+        material_node_name,
+        material_input_name,
+        texmap,
+        layer_name.c_str(),
+        output_name,
+        time);
+}
+
+bool get_constant_map_value(Texmap* texmap, const TimeValue time, AColor& value)
+{
+    if (texmap == nullptr)
+        return false;
+
+    IParamBlock2* pblock = texmap->GetParamBlock(0);
+    if (pblock == nullptr)
+        return false;
+
+    if (texmap->ClassID() == Class_ID(0x58F82B74, 0x73B75D7F))      // VRayColor
+    {
+        const Color color = get_map_param(pblock, L"color", time, Color(0.5f, 0.5f, 0.5f));
+        const float multiplier = get_map_param(pblock, L"rgb_multiplier", time, 1.0f);
+        value = AColor(color * multiplier, get_map_param(pblock, L"alpha", time, 1.0f));
+        return true;
+    }
+
+    switch (texmap->ClassID().PartA())
+    {
+      case OUTPUT_CLASS_ID:
+        {
+            AColor input;
+            if (!get_constant_map_value(get_map_param<Texmap*>(pblock, L"map1", time, nullptr), time, input))
+                return false;
+
+            value = apply_texture_output(texmap, input);
+            return true;
+        }
+
+      case BMTEX_CLASS_ID:
+        {
+            // A bitmap is constant when its output doesn't depend on the texels, e.g. with an output amount of 0.
+            if (!has_flat_texture_output(texmap, time))
+                return false;
+
+            value = apply_texture_output(texmap, AColor(0.0f, 0.0f, 0.0f, 0.0f));
+            return true;
+        }
+
+      case CHECKER_CLASS_ID:
+        {
+            AColor color1, color2;
+            if (!get_constant_slot_value(pblock, L"color1", L"map1", L"map1Enabled", time, color1) ||
+                !get_constant_slot_value(pblock, L"color2", L"map2", L"map2Enabled", time, color2) ||
+                color1 != color2)
+                return false;
+
+            value = apply_texture_output(texmap, color1);
+            return true;
+        }
+
+      case GRADIENT_CLASS_ID:
+        {
+            AColor color1, color2, color3;
+            if (!get_constant_slot_value(pblock, L"color1", L"map1", L"map1Enabled", time, color1) ||
+                !get_constant_slot_value(pblock, L"color2", L"map2", L"map2Enabled", time, color2) ||
+                !get_constant_slot_value(pblock, L"color3", L"map3", L"map3Enabled", time, color3) ||
+                color1 != color2 ||
+                color1 != color3)
+                return false;
+
+            value = apply_texture_output(texmap, color1);
+            return true;
+        }
+
+      case NOISE_CLASS_ID:
+        {
+            AColor color1, color2;
+            if (!get_constant_slot_value(pblock, L"color1", L"map1", L"map1On", time, color1) ||
+                !get_constant_slot_value(pblock, L"color2", L"map2", L"map2On", time, color2) ||
+                color1 != color2)
+                return false;
+
+            value = apply_texture_output(texmap, color1);
+            return true;
+        }
+
+      default:
+        return false;
+    }
+}
+
+bool get_constant_map_mono_value(Texmap* texmap, const TimeValue time, float& value)
+{
+    if (texmap == nullptr)
+        return false;
+
+    IParamBlock2* pblock = texmap->GetParamBlock(0);
+    if (pblock == nullptr)
+        return false;
+
+    switch (texmap->ClassID().PartA())
+    {
+      case OUTPUT_CLASS_ID:
+        {
+            // The float path feeds the input map to as_max_color_balance's float input.
+            float input;
+            if (!get_constant_map_mono_value(get_map_param<Texmap*>(pblock, L"map1", time, nullptr), time, input))
+                return false;
+
+            TextureOutput* output = find_texture_output(texmap);
+            value = output != nullptr ? output->Filter(input) : input;
+            return true;
+        }
+
+      case BMTEX_CLASS_ID:
+        {
+            if (!has_flat_texture_output(texmap, time))
+                return false;
+
+            value = find_texture_output(texmap)->Filter(0.0f);
+            return true;
+        }
+
+      default:
+        {
+            // Procedural map shaders output the average of their color channels as out_outFloat.
+            AColor color;
+            if (!get_constant_map_value(texmap, time, color))
+                return false;
+
+            value = (color.r + color.g + color.b) / 3.0f;
+            return true;
+        }
+    }
+}
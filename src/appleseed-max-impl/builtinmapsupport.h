@@ -36,16 +36,33 @@
 #include "foundation/image/color.h"
 
 // 3ds Max Headers.
+#include <acolor.h>
 #include <color.h>
 #include <maxtypes.h>
 
 // Standard headers.
 #include <string>
+#include <type_traits>
 
 // Forward declarations.
 namespace renderer { class ShaderGroup; }
 class Texmap;
 
+// Return true and the value of a map if it evaluates to the same value everywhere.
+// Such maps are folded into plain shader parameters instead of being connected.
+bool get_constant_map_value(
+    Texmap*                 texmap,
+    const TimeValue         time,
+    AColor&                 value);
+
+// Same as get_constant_map_value() for maps connected to float inputs. The value is the one
+// the float shading path reads: the filtered mono value for bitmaps and Output maps, the
+// average of the color channels for procedural maps.
+bool get_constant_map_mono_value(
+    Texmap*                 texmap,
+    const TimeValue         time,
+    float&                  value);
+
 void connect_output_map(
     renderer::ShaderGroup&  shader_group,
     const char*             material_node_name,
@@ -69,6 +86,30 @@ void connect_output_selector(
     Texmap*                 texmap,
     const TimeValue         time);
 
+void connect_checker_map(
+    renderer::ShaderGroup&  shader_group,
+    const char*             material_node_name,
+    const char*             material_input_name,
+    Texmap*                 texmap,
+    const char*             output_name,
+    const TimeValue         time);
+
+void connect_gradient_map(
+    renderer::ShaderGroup&  shader_group,
+    const char*             material_node_name,
+    const char*             material_input_name,
+    Texmap*                 texmap,
+    const char*             output_name,
+    const TimeValue         time);
+
+void connect_noise_map(
+    renderer::ShaderGroup&  shader_group,
+    const char*             material_node_name,
+    const char*             material_input_name,
+    Texmap*                 texmap,
+    const char*             output_name,
+    const TimeValue         time);
+
 template <typename T>
 void create_supported_texture(
     renderer::ShaderGroup&  shader_group,
@@ -92,6 +133,10 @@ void create_supported_texture(
         return;
     }
 
+    // Outputs of the native procedural map shaders.
+    const char* output_name =
+        std::is_same<T, float>::value ? "out_outFloat" : "out_outColor";
+
     switch (part_a)
     {
       case OUTPUT_CLASS_ID:
@@ -102,6 +147,37 @@ void create_supported_texture(
             texmap,
             const_value,
             time);
+        break;
+
+      case CHECKER_CLASS_ID:
+        connect_checker_map(
+            shader_group,
+            material_node_name,
+            material_input_name,
+            texmap,
+            output_name,
+            time);
+        break;
+
+      case GRADIENT_CLASS_ID:
+        connect_gradient_map(
+            shader_group,
+            material_node_name,
+            material_input_name,
+            texmap,
+            output_name,
+            time);
+        break;
+
+      case NOISE_CLASS_ID:
+        connect_noise_map(
+            shader_group,
+            material_node_name,
+            material_input_name,
+            texmap,
+            output_name,
+            time);
+        break;
 
       default:
         break;
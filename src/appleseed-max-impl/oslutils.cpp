@@ -51,6 +51,9 @@
 #include <stdmat.h>
 #include <iparamm2.h>
 
+// Standard headers.
+#include <cstring>
+
 namespace asf = foundation;
 namespace asr = renderer;
 
@@ -233,6 +236,121 @@ std::string fmt_osl_expr(Texmap* texmap)
     else return fmt_osl_expr(std::string());
 }
 
+bool parse_osl_string_expr(const std::string& expr, std::string& s)
+{
+    const std::string prefix = fmt_osl_expr(std::string());
+    if (expr.compare(0, prefix.size(), prefix) != 0)
+        return false;
+
+    s = expr.substr(prefix.size());
+    return true;
+}
+
+LayerNames::LayerNames(const char* material_node_name, const char* material_input_name)
+  : m_base(material_node_name)
+{
+    m_base += '_';
+    m_base += material_input_name;
+}
+
+LayerNames::LayerNames(const char* material_node_name)
+  : m_base(material_node_name)
+{
+}
+
+const std::string& LayerNames::base() const
+{
+    return m_base;
+}
+
+std::string LayerNames::get(const char* layer) const
+{
+    const size_t layer_length = std::strlen(layer);
+
+    std::string name;
+    name.reserve(m_base.size() + 1 + layer_length);
+    name.append(m_base);
+    name.push_back('_');
+    name.append(layer, layer_length);
+
+    return name;
+}
+
+namespace
+{
+    // Same channel as the single-channel lookup of as_max_float_texture.
+    const char* ColorToFloatSource =
+        "shader as_max_color_to_float(\n"
+        "    color ColorIn = color(0.0),\n"
+        "    output float FloatOut = 0.0)\n"
+        "{\n"
+        "    FloatOut = ColorIn[0];\n"
+        "}\n";
+
+    // Names of the layers looking up the texels of a bitmap, shared by all inputs of a material node.
+    LayerNames get_bitmap_layer_names(const char* material_node_name, Texmap* texmap)
+    {
+        const std::string bitmap_id = "bitmap_" + asf::to_string(Animatable::GetHandleByAnim(texmap));
+        return LayerNames(material_node_name, bitmap_id.c_str());
+    }
+
+    // Add the layers looking up the texels of a bitmap unless another input of the same material node
+    // already did, and return the name of the layer whose ColorOut output holds the texels.
+    std::string add_bitmap_lookup(
+        asr::ShaderGroup&   shader_group,
+        const char*         material_node_name,
+        Texmap*             texmap,
+        const TimeValue     time)
+    {
+        const LayerNames layer_names = get_bitmap_layer_names(material_node_name, texmap);
+
+        const auto texture_layer_name = layer_names.get("texture");
+        if (shader_group.shaders().get_by_name(texture_layer_name.c_str()) != nullptr)
+            return texture_layer_name;
+
+        const auto uv_transform_layer_name = layer_names.get("uv_transform");
+        shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
+
+        shader_group.add_shader("shader", "as_max_color_texture", texture_layer_name.c_str(),
+            asr::ParamArray()
+                .insert("Filename", fmt_osl_expr(texmap)));
+
+        shader_group.add_connection(
+            uv_transform_layer_name.c_str(), "out_U",
+            texture_layer_name.c_str(), "U");
+
+        shader_group.add_connection(
+            uv_transform_layer_name.c_str(), "out_V",
+            texture_layer_name.c_str(), "V");
+
+        return texture_layer_name;
+    }
+}
+
+float fold_float_texture(
+    Texmap*             texmap,
+    const float         const_value,
+    const TimeValue     time)
+{
+    float value;
+    if (get_constant_map_mono_value(texmap, time, value))
+        return value;
+
+    return const_value;
+}
+
+asf::Color3f fold_color_texture(
+    Texmap*             texmap,
+    const Color         const_color,
+    const TimeValue     time)
+{
+    AColor value;
+    if (get_constant_map_value(texmap, time, value))
+        return asf::Color3f(value.r, value.g, value.b);
+
+    return to_color3f(const_color);
+}
+
 void connect_float_texture(
     asr::ShaderGroup&   shader_group,
     const char*         material_node_name,
@@ -241,6 +359,10 @@ void connect_float_texture(
     const float         const_value,
     const TimeValue     time)
 {
+    float constant_value;
+    if (get_constant_map_mono_value(texmap, time, constant_value))
+        return;
+
     if (is_supported_procedural_texture(texmap, false))
     {
         create_supported_texture(
@@ -262,10 +384,12 @@ void connect_float_texture(
 
     if (is_bitmap_texture(texmap))
     {
-        const auto uv_transform_layer_name = asf::format("{0}_{1}_uv_transform", material_node_name, material_input_name);
+        const LayerNames layer_names(material_node_name, material_input_name);
+
+        const auto uv_transform_layer_name = layer_names.get("uv_transform");
         shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
 
-        const auto layer_name = asf::format("{0}_{1}_texture", material_node_name, material_input_name);
+        const auto layer_name = layer_names.get("texture");
         shader_group.add_shader("shader", "as_max_float_texture", layer_name.c_str(),
             asr::ParamArray()
                 .insert("Filename", fmt_osl_expr(texmap)));
@@ -273,7 +397,7 @@ void connect_float_texture(
         asr::ParamArray color_balance_params = get_output_params(texmap, time)
             .insert("in_constantFloat", fmt_osl_expr(const_value));
 
-        const auto color_balance_layer_name = asf::format("{0}_{1}_color_balance", material_node_name, material_input_name);
+        const auto color_balance_layer_name = layer_names.get("color_balance");
         shader_group.add_shader("shader", "as_max_color_balance", color_balance_layer_name.c_str(), color_balance_params);
 
         shader_group.add_connection(
@@ -302,6 +426,10 @@ void connect_color_texture(
     const Color         const_color,
     const TimeValue     time)
 {
+    AColor constant_value;
+    if (get_constant_map_value(texmap, time, constant_value))
+        return;
+
     if (is_supported_procedural_texture(texmap, false))
     {
         create_supported_texture(
@@ -323,33 +451,23 @@ void connect_color_texture(
     
     if (is_bitmap_texture(texmap))
     {
-        const auto uv_transform_layer_name = asf::format("{0}_{1}_uv_transform", material_node_name, material_input_name);
-        shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
+        const LayerNames layer_names(material_node_name, material_input_name);
+
+        // Inputs sharing this bitmap share its texture lookup.
+        const auto texture_layer_name = add_bitmap_lookup(shader_group, material_node_name, texmap, time);
+
         if (!is_linear_texture(static_cast<BitmapTex*>(texmap)))
         {
-            const auto texture_layer_name = asf::format("{0}_{1}_texture", material_node_name, material_input_name);
-            shader_group.add_shader("shader", "as_max_color_texture", texture_layer_name.c_str(),
-                asr::ParamArray()
-                    .insert("Filename", fmt_osl_expr(texmap)));
-
-            const auto srgb_to_linear_layer_name = asf::format("{0}_{1}_srgb_to_linear", material_node_name, material_input_name);
+            const auto srgb_to_linear_layer_name = layer_names.get("srgb_to_linear");
             shader_group.add_shader("shader", "as_max_srgb_to_linear_rgb", srgb_to_linear_layer_name.c_str(),
                 asr::ParamArray());
 
             asr::ParamArray color_balance_params = get_output_params(texmap, time)
                 .insert("in_constantColor", fmt_osl_expr(to_color3f(const_color)));
 
-            const auto color_balance_layer_name = asf::format("{0}_{1}_color_balance", material_node_name, material_input_name);
+            const auto color_balance_layer_name = layer_names.get("color_balance");
             shader_group.add_shader("shader", "as_max_color_balance", color_balance_layer_name.c_str(), color_balance_params);
 
-            shader_group.add_connection(
-                uv_transform_layer_name.c_str(), "out_U",
-                texture_layer_name.c_str(), "U");
-
-            shader_group.add_connection(
-                uv_transform_layer_name.c_str(), "out_V",
-                texture_layer_name.c_str(), "V");
-
             shader_group.add_connection(
                 texture_layer_name.c_str(), "ColorOut",
                 srgb_to_linear_layer_name.c_str(), "ColorIn");
@@ -364,25 +482,12 @@ void connect_color_texture(
         }
         else
         {
-            const auto texture_layer_name = asf::format("{0}_{1}_texture", material_node_name, material_input_name);
-            shader_group.add_shader("shader", "as_max_color_texture", texture_layer_name.c_str(),
-                asr::ParamArray()
-                    .insert("Filename", fmt_osl_expr(texmap)));
-
             asr::ParamArray color_balance_params = get_output_params(texmap, time)
                 .insert("in_constantColor", fmt_osl_expr(to_color3f(const_color)));
 
-            const auto color_balance_layer_name = asf::format("{0}_{1}_color_balance", material_node_name, material_input_name);
+            const auto color_balance_layer_name = layer_names.get("color_balance");
             shader_group.add_shader("shader", "as_max_color_balance", color_balance_layer_name.c_str(), color_balance_params);
 
-            shader_group.add_connection(
-                uv_transform_layer_name.c_str(), "out_U",
-                texture_layer_name.c_str(), "U");
-
-            shader_group.add_connection(
-                uv_transform_layer_name.c_str(), "out_V",
-                texture_layer_name.c_str(), "V");
-
             shader_group.add_connection(
                 texture_layer_name.c_str(), "ColorOut",
                 color_balance_layer_name.c_str(), "in_defaultColor");
@@ -403,9 +508,16 @@ void connect_bump_map(
     const float         amount,
     const TimeValue     time)
 {
+    // A constant height field doesn't perturb the normal.
+    float constant_value;
+    if (get_constant_map_mono_value(texmap, time, constant_value))
+        return;
+
+    const LayerNames layer_names(material_node_name);
+
     if (is_supported_procedural_texture(texmap, false) || is_osl_texture(texmap))
     {
-        auto bump_map_layer_name = asf::format("{0}_bump_map", material_node_name);
+        auto bump_map_layer_name = layer_names.get("bump_map");
 
         connect_float_texture(
             shader_group,
@@ -428,29 +540,86 @@ void connect_bump_map(
 
     if (is_bitmap_texture(texmap))
     {
-        auto uv_transform_layer_name = asf::format("{0}_bump_uv_transform", material_node_name);
-        shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
+        // A height map baked into a normal map only takes a single texture lookup.
+        const std::string normal_map_filepath = get_bump_normal_map(static_cast<BitmapTex*>(texmap), time);
+        if (!normal_map_filepath.empty())
+        {
+            auto uv_transform_layer_name = layer_names.get("bump_uv_transform");
+            shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
 
-        auto texture_layer_name = asf::format("{0}_bump_map_texture", material_node_name);
-        shader_group.add_shader("shader", "as_max_float_texture", texture_layer_name.c_str(),
-            asr::ParamArray()
-                .insert("Filename", fmt_osl_expr(texmap)));
+            auto texture_layer_name = layer_names.get("bump_normal_map_texture");
+            shader_group.add_shader("shader", "as_max_color_texture", texture_layer_name.c_str(),
+                asr::ParamArray()
+                    .insert("Filename", fmt_osl_expr(normal_map_filepath)));
+
+            auto normal_map_layer_name = layer_names.get("bump_map");
+            shader_group.add_shader("shader", "as_max_normal_map", normal_map_layer_name.c_str(),
+                asr::ParamArray()
+                    .insert("UpVector", fmt_osl_expr("Blue"))
+                    .insert("Amount", fmt_osl_expr(amount)));
+
+            shader_group.add_connection(
+                uv_transform_layer_name.c_str(), "out_U",
+                texture_layer_name.c_str(), "U");
+
+            shader_group.add_connection(
+                uv_transform_layer_name.c_str(), "out_V",
+                texture_layer_name.c_str(), "V");
+
+            shader_group.add_connection(
+                texture_layer_name.c_str(), "ColorOut",
+                normal_map_layer_name.c_str(), "Color");
+            shader_group.add_connection(
+                normal_map_layer_name.c_str(), "NormalOut",
+                material_node_name, material_normal_input_name);
+            shader_group.add_connection(
+                normal_map_layer_name.c_str(), "TangentOut",
+                material_node_name, material_tn_input_name);
+
+            return;
+        }
+
+        auto bump_map_layer_name = layer_names.get("bump_map");
+        auto height_layer_name = get_bitmap_layer_names(material_node_name, texmap).get("texture");
+
+        if (shader_group.shaders().get_by_name(height_layer_name.c_str()) != nullptr)
+        {
+            // Another input of this material, typically the diffuse color, already looks up this bitmap:
+            // take the height from that lookup rather than reading the file again.
+            const auto shared_layer_name = height_layer_name;
+            height_layer_name = layer_names.get("bump_height");
+            shader_group.add_source_shader("shader", "as_max_color_to_float", height_layer_name.c_str(), ColorToFloatSource,
+                asr::ParamArray());
+
+            shader_group.add_connection(
+                shared_layer_name.c_str(), "ColorOut",
+                height_layer_name.c_str(), "ColorIn");
+        }
+        else
+        {
+            auto uv_transform_layer_name = layer_names.get("bump_uv_transform");
+            shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
+
+            height_layer_name = layer_names.get("bump_map_texture");
+            shader_group.add_shader("shader", "as_max_float_texture", height_layer_name.c_str(),
+                asr::ParamArray()
+                    .insert("Filename", fmt_osl_expr(texmap)));
+
+            shader_group.add_connection(
+                uv_transform_layer_name.c_str(), "out_U",
+                height_layer_name.c_str(), "U");
+
+            shader_group.add_connection(
+                uv_transform_layer_name.c_str(), "out_V",
+                height_layer_name.c_str(), "V");
+        }
 
-        auto bump_map_layer_name = asf::format("{0}_bump_map", material_node_name);
         shader_group.add_shader("shader", "as_max_bump_map", bump_map_layer_name.c_str(),
             asr::ParamArray()
                 .insert("Amount", fmt_osl_expr(amount)));
 
         shader_group.add_connection(
-            uv_transform_layer_name.c_str(), "out_U",
-            texture_layer_name.c_str(), "U");
-
-        shader_group.add_connection(
-            uv_transform_layer_name.c_str(), "out_V",
-            texture_layer_name.c_str(), "V");
-
-        shader_group.add_connection(
-            texture_layer_name.c_str(), "FloatOut",
+            height_layer_name.c_str(), "FloatOut",
             bump_map_layer_name.c_str(), "Height");
         shader_group.add_connection(
             bump_map_layer_name.c_str(), "NormalOut",
@@ -468,9 +637,11 @@ void connect_normal_map(
     const float         amount,
     const TimeValue     time)
 {
+    const LayerNames layer_names(material_node_name);
+
     if (is_supported_procedural_texture(texmap, false) || is_osl_texture(texmap))
     {
-        auto normal_map_layer_name = asf::format("{0}_normal_map", material_node_name);
+        auto normal_map_layer_name = layer_names.get("normal_map");
 
         connect_color_texture(
             shader_group,
@@ -482,6 +653,7 @@ void connect_normal_map(
 
         shader_group.add_shader("shader", "as_max_normal_map", normal_map_layer_name.c_str(),
             asr::ParamArray()
+                .insert("Color", fmt_osl_expr(fold_color_texture(texmap, Color(1.0f, 1.0f, 1.0f), time)))
                 .insert("UpVector", fmt_osl_expr(up_vector == 0 ? "Green" : "Blue"))
                 .insert("Amount", fmt_osl_expr(amount)));
 
@@ -497,28 +669,14 @@ void connect_normal_map(
 
     if (is_bitmap_texture(texmap))
     {
-        auto uv_transform_layer_name = asf::format("{0}_bump_uv_transform", material_node_name);
-        shader_group.add_shader("shader", "as_max_uv_transform", uv_transform_layer_name.c_str(), get_uv_params(texmap, time));
-
-        auto texture_layer_name = asf::format("{0}_normal_map_texture", material_node_name);
-        shader_group.add_shader("shader", "as_max_color_texture", texture_layer_name.c_str(),
-            asr::ParamArray()
-                .insert("Filename", fmt_osl_expr(texmap)));
+        auto texture_layer_name = add_bitmap_lookup(shader_group, material_node_name, texmap, time);
 
-        auto normal_map_layer_name = asf::format("{0}_normal_map", material_node_name);
+        auto normal_map_layer_name = layer_names.get("normal_map");
         shader_group.add_shader("shader", "as_max_normal_map", normal_map_layer_name.c_str(),
             asr::ParamArray()
                 .insert("UpVector", fmt_osl_expr(up_vector == 0 ? "Green" : "Blue"))
                 .insert("Amount", fmt_osl_expr(amount)));
 
-        shader_group.add_connection(
-            uv_transform_layer_name.c_str(), "out_U",
-            texture_layer_name.c_str(), "U");
-
-        shader_group.add_connection(
-            uv_transform_layer_name.c_str(), "out_V",
-            texture_layer_name.c_str(), "V");
-
         shader_group.add_connection(
             texture_layer_name.c_str(), "ColorOut",
             normal_map_layer_name.c_str(), "Color");
@@ -561,7 +719,9 @@ void connect_sub_mtl(
     // Don't copy last shader and last connection
     for (auto shader = mtl_group->shaders().begin(); shader != --(mtl_group->shaders().end()); shader++)
     {
-        shader_group.add_shader(shader->get_type(), shader->get_shader(), shader->get_layer(), shader->get_parameters());
+        if (shader->get_source_code() != nullptr)
+            shader_group.add_source_shader(shader->get_type(), shader->get_shader(), shader->get_layer(), shader->get_source_code(), shader->get_parameters());
+        else shader_group.add_shader(shader->get_type(), shader->get_shader(), shader->get_layer(), shader->get_parameters());
     }
 
     for (auto conn = mtl_group->shader_connections().begin(); conn != --(mtl_group->shader_connections().end()); conn++)
@@ -601,6 +761,12 @@ void create_osl_shader(
                     {
                         const float constant_value = 
                             max_param.m_has_constant ? param_block->GetFloat(max_param.m_max_param_id, time, FOREVER) : 1.0f;
+
+                        // Constant maps are not connected: set their value on the shader instead.
+                        params.insert(
+                            max_param.m_osl_param_name.c_str(),
+                            fmt_osl_expr(fold_float_texture(texmap, constant_value, time)));
+
                         connect_float_texture(
                             shader_group,
                             layer_name,
@@ -614,6 +780,11 @@ void create_osl_shader(
                     {
                         const Color constant_color = 
                             max_param.m_has_constant ? param_block->GetColor(max_param.m_max_param_id, time, FOREVER) : Color(1.0, 1.0, 1.0);
+
+                        params.insert(
+                            max_param.m_osl_param_name.c_str(),
+                            fmt_osl_expr(fold_color_texture(texmap, constant_color, time)));
+
                         connect_color_texture(
                             shader_group,
                             layer_name,
@@ -49,6 +49,28 @@ class Mtl;
 class OSLShaderInfo;
 class Texmap;
 
+//
+// Names of the shader layers created for a material node or one of its inputs, of the form
+// <node>_<layer> or <node>_<input>_<layer>. The common part is built once and each layer name
+// is appended to it, instead of formatting every name from scratch.
+//
+
+class LayerNames
+{
+  public:
+    LayerNames(const char* material_node_name, const char* material_input_name);
+    explicit LayerNames(const char* material_node_name);
+
+    // Return the common part of the layer names, e.g. <node>_<input>.
+    const std::string& base() const;
+
+    // Return the name of a given layer.
+    std::string get(const char* layer) const;
+
+  private:
+    std::string m_base;
+};
+
 renderer::ParamArray get_uv_params(Texmap* texmap, const TimeValue time);
 
 renderer::ParamArray get_output_params(Texmap* texmap, const TimeValue time);
@@ -69,6 +91,23 @@ std::string fmt_osl_point_expr(const foundation::Vector3f& point);
 
 std::string fmt_osl_expr(Texmap* texmap);
 
+// Retrieve the value of a string parameter formatted by fmt_osl_expr(const std::string&).
+// Return false if `expr` is not a string parameter.
+bool parse_osl_string_expr(const std::string& expr, std::string& s);
+
+// Return the value a material input connected to a map should have. Constant maps are not
+// connected by connect_float_texture() and connect_color_texture(): their value is returned
+// instead so that it can be set directly on the material shader.
+float fold_float_texture(
+    Texmap*                 texmap,
+    const float             const_value,
+    const TimeValue         time);
+
+foundation::Color3f fold_color_texture(
+    Texmap*                 texmap,
+    const Color             const_color,
+    const TimeValue         time);
+
 void connect_float_texture(
     renderer::ShaderGroup&  shader_group,
     const char*             material_node_name,
@@ -53,11 +53,9 @@ std::string fmt_se_expr(BitmapTex* bitmap_tex)
     DbgAssert(bitmap_tex != nullptr);
     const std::string filepath = wide_to_utf8(bitmap_tex->GetMap().GetFullFilePath());
 
-    Bitmap* bitmap = bitmap_tex->GetBitmap(0);
-    DbgAssert(bitmap != nullptr);
-
-    const int width = bitmap->Width();
-    const int height = bitmap->Height();
+    // Callers check is_bitmap_texture() first.
+    int width = 0, height = 0;
+    get_bitmap_texture_size(bitmap_tex, width, height);
 
     return asf::format("texture(\"{0}\", $u % {1}, $v % {2})", filepath, width, height);
 }
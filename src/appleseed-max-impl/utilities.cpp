@@ -36,16 +36,27 @@
 
 // appleseed.renderer headers.
 #include "renderer/api/color.h"
+#include "renderer/api/log.h"
 #include "renderer/api/source.h"
 #include "renderer/api/texture.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
+#include "foundation/image/colorspace.h"
+#include "foundation/image/genericimagefilereader.h"
+#include "foundation/image/genericimagefilewriter.h"
+#include "foundation/image/image.h"
+#include "foundation/image/imageattributes.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
 #include "foundation/utility/searchpaths.h"
 #include "foundation/utility/siphash.h"
 #include "foundation/utility/string.h"
 
+// Boost headers.
+#include "boost/thread/tss.hpp"
+
 // 3ds Max Headers.
 #include <AssetManagement/AssetUser.h>
 #include <assert1.h>
@@ -59,6 +70,18 @@
 // Windows headers.
 #include <Shlwapi.h>
 
+// Standard headers.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
 namespace asf = foundation;
 namespace asr = renderer;
 
@@ -150,6 +173,150 @@ void update_map_buttons(IParamMap2* param_map)
     }
 }
 
+namespace
+{
+    // Build a key identifying the current version of a file from its path and modification time,
+    // or return false if the file doesn't exist.
+    bool make_file_version_key(const std::wstring& filepath, std::string& key)
+    {
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+        if (GetFileAttributesEx(filepath.c_str(), GetFileExInfoStandard, &attributes) == FALSE)
+            return false;
+
+        // Windows paths are case-insensitive.
+        key =
+            asf::lower_case(wide_to_utf8(filepath)) + "|" +
+            asf::to_string(attributes.ftLastWriteTime.dwHighDateTime) + ":" +
+            asf::to_string(attributes.ftLastWriteTime.dwLowDateTime);
+
+        return true;
+    }
+
+    void get_bitmap_type_format(
+        const int           bitmap_type,
+        const bool          has_alpha,
+        BitmapFileInfo&     info)
+    {
+        switch (bitmap_type)
+        {
+          case BMM_LINE_ART:
+            info.m_channel_count = 1;
+            info.m_bits_per_channel = 1;
+            break;
+
+          case BMM_GRAY_8:
+            info.m_channel_count = 1;
+            info.m_bits_per_channel = 8;
+            break;
+
+          case BMM_GRAY_16:
+            info.m_channel_count = 1;
+            info.m_bits_per_channel = 16;
+            break;
+
+          case BMM_TRUE_16:
+            info.m_channel_count = 3;
+            info.m_bits_per_channel = 5;
+            break;
+
+          case BMM_PALETTED:
+          case BMM_TRUE_24:
+            info.m_channel_count = 3;
+            info.m_bits_per_channel = 8;
+            break;
+
+          case BMM_TRUE_48:
+            info.m_channel_count = 3;
+            info.m_bits_per_channel = 16;
+            break;
+
+          case BMM_TRUE_64:
+            info.m_channel_count = 4;
+            info.m_bits_per_channel = 16;
+            break;
+
+          case BMM_FLOAT_GRAY_32:
+            info.m_channel_count = 1;
+            info.m_bits_per_channel = 32;
+            break;
+
+          case BMM_FLOAT_RGB_32:
+            info.m_channel_count = 3;
+            info.m_bits_per_channel = 32;
+            break;
+
+          case BMM_FLOAT_RGBA_32:
+            info.m_channel_count = 4;
+            info.m_bits_per_channel = 32;
+            break;
+
+          default:
+            info.m_channel_count = has_alpha ? 4 : 3;
+            info.m_bits_per_channel = 8;
+            break;
+        }
+    }
+
+    // Header information of the bitmap files probed during this session: file path and modification time -> information.
+    // Files that could not be probed have a zero width.
+    std::map<std::string, BitmapFileInfo> g_bitmap_file_infos;
+}
+
+bool probe_bitmap_file(const std::wstring& filepath, BitmapFileInfo& info)
+{
+    std::string key;
+    if (!make_file_version_key(filepath, key))
+        return false;
+
+    const auto it = g_bitmap_file_infos.find(key);
+    if (it != g_bitmap_file_infos.end())
+    {
+        info = it->second;
+        return info.m_width > 0;
+    }
+
+    // GetImageInfo() only reads the file header.
+    BitmapInfo bi;
+    bi.SetName(filepath.c_str());
+    if (TheManager->GetImageInfo(&bi) == BMMRES_SUCCESS)
+    {
+        info.m_width = bi.Width();
+        info.m_height = bi.Height();
+        get_bitmap_type_format(bi.Type(), (bi.Flags() & MAP_HAS_ALPHA) != 0, info);
+    }
+    else
+    {
+        info.m_width = 0;
+        info.m_height = 0;
+        info.m_channel_count = 0;
+        info.m_bits_per_channel = 0;
+    }
+
+    g_bitmap_file_infos.insert(std::make_pair(key, info));
+
+    return info.m_width > 0;
+}
+
+bool get_bitmap_texture_size(BitmapTex* bitmap_tex, int& width, int& height)
+{
+    BitmapFileInfo info;
+    if (probe_bitmap_file(bitmap_tex->GetMap().GetFullFilePath().data(), info))
+    {
+        width = info.m_width;
+        height = info.m_height;
+        return true;
+    }
+
+    // Bitmaps that don't come from a readable file must be loaded by 3ds Max.
+    Bitmap* bitmap = bitmap_tex->GetBitmap(0);
+    if (bitmap == nullptr)
+        return false;
+
+    width = bitmap->Width();
+    height = bitmap->Height();
+    return true;
+}
+
 bool is_bitmap_texture(Texmap* map)
 {
     if (map == nullptr)
@@ -158,12 +325,21 @@ bool is_bitmap_texture(Texmap* map)
     if (map->ClassID() != Class_ID(BMTEX_CLASS_ID, 0))
         return false;
 
-    Bitmap* bitmap = static_cast<BitmapTex*>(map)->GetBitmap(0);
+    int width, height;
+    return get_bitmap_texture_size(static_cast<BitmapTex*>(map), width, height);
+}
 
-    if (bitmap == nullptr)
+bool is_file_bitmap_texture(Texmap* map)
+{
+    if (map == nullptr)
         return false;
 
-    return true;
+    if (map->ClassID() != Class_ID(BMTEX_CLASS_ID, 0))
+        return false;
+
+    const MSTR filepath = static_cast<BitmapTex*>(map)->GetMap().GetFullFilePath();
+
+    return !filepath.isNull() && PathFileExists(filepath.data()) == TRUE;
 }
 
 bool is_osl_texture(Texmap* map)
@@ -187,6 +363,9 @@ bool is_supported_procedural_texture(Texmap* map, const bool use_max_procedural_
         switch (part_a)
         {
           case OUTPUT_CLASS_ID:
+          case CHECKER_CLASS_ID:        // translated to built-in OSL shaders
+          case GRADIENT_CLASS_ID:
+          case NOISE_CLASS_ID:
             return true;
 
           default:
@@ -333,6 +512,565 @@ std::string insert_texture_and_instance(
     return std::string();
 }
 
+namespace
+{
+    struct SharedTextures
+    {
+        asr::BaseGroup*                     m_base_group;
+        std::map<std::string, std::string>  m_texture_names;    // file path and color space -> texture name
+
+        // Texture resolution policy.
+        float                               m_footprint;        // in pixels, 0 if unknown
+        TimeValue                           m_time;
+        std::set<std::string>               m_bound_variants;   // variant file paths
+        asf::uint64                         m_saved_bytes;
+    };
+
+    // Only accessed from the main thread, while a project is being built.
+    SharedTextures* g_shared_textures = nullptr;
+
+    // Return the path of the smallest variant of `filepath` providing at least `required_size` pixels
+    // along its largest dimension, or `filepath` itself if there is no such variant.
+    std::string select_texture_variant(
+        const std::string&  filepath,
+        const float         required_size,
+        SharedTextures&     shared_textures)
+    {
+        BitmapFileInfo info;
+        if (!probe_bitmap_file(utf8_to_wide(filepath), info))
+            return filepath;
+
+        const size_t width = static_cast<size_t>(info.m_width);
+        const size_t height = static_cast<size_t>(info.m_height);
+        const size_t full_size = std::max(width, height);
+
+        const size_t separator = filepath.find_last_of("\\/");
+        const size_t dot = filepath.find_last_of('.');
+        if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+            return filepath;
+
+        for (size_t size = 256; size < full_size && size <= 8192; size *= 2)
+        {
+            if (size < required_size)
+                continue;
+
+            const std::string variant =
+                filepath.substr(0, dot) + "_" + asf::to_string(size) + filepath.substr(dot);
+            if (PathFileExists(utf8_to_wide(variant).c_str()) != TRUE)
+                continue;
+
+            const double scale = static_cast<double>(size) / full_size;
+            const size_t bytes_per_pixel = (info.m_channel_count * info.m_bits_per_channel + 7) / 8;
+            const asf::uint64 full_bytes = static_cast<asf::uint64>(width) * height * bytes_per_pixel;
+            const asf::uint64 variant_bytes = static_cast<asf::uint64>(full_bytes * scale * scale);
+
+            // Only count each variant once, however many bitmaps bind it.
+            if (shared_textures.m_bound_variants.insert(variant).second)
+                shared_textures.m_saved_bytes += full_bytes - variant_bytes;
+
+            RENDERER_LOG_DEBUG(
+                "using %s instead of %s (%s pixels on screen).",
+                variant.c_str(),
+                filepath.c_str(),
+                asf::pretty_uint(static_cast<asf::uint64>(required_size)).c_str());
+
+            return variant;
+        }
+
+        return filepath;
+    }
+
+    // Insert a disk texture for `texture_params` (which must include a file name) and an instance of it.
+    // Maps reading the same file share the texture, but each map gets its own instance named after it.
+    std::string insert_disk_texture_and_instance(
+        asr::BaseGroup&         base_group,
+        const std::string&      name,
+        const asr::ParamArray&  texture_params,
+        const asr::ParamArray&  texture_instance_params)
+    {
+        std::string texture_name = name;
+        if (g_shared_textures != nullptr)
+        {
+            // Windows paths are case-insensitive.
+            const std::string key =
+                asf::lower_case(texture_params.get<std::string>("filename")) + "|" +
+                texture_params.get<std::string>("color_space");
+
+            const auto it = g_shared_textures->m_texture_names.find(key);
+            if (it == g_shared_textures->m_texture_names.end())
+            {
+                asr::BaseGroup& texture_group = *g_shared_textures->m_base_group;
+                texture_name = make_unique_name(texture_group.textures(), texture_name);
+                texture_group.textures().insert(
+                    asr::DiskTexture2dFactory().create(
+                        texture_name.c_str(),
+                        texture_params,
+                        asf::SearchPaths()));
+                g_shared_textures->m_texture_names.insert(std::make_pair(key, texture_name));
+            }
+            else texture_name = it->second;
+        }
+        else if (base_group.textures().get_by_name(texture_name.c_str()) == nullptr)
+        {
+            base_group.textures().insert(
+                asr::DiskTexture2dFactory().create(
+                    texture_name.c_str(),
+                    texture_params,
+                    asf::SearchPaths()));
+        }
+
+        // Reuse the instance of this map only if it has the same texture and parameters.
+        std::string texture_instance_name = name + "_inst";
+        const asr::TextureInstance* texture_instance =
+            base_group.texture_instances().get_by_name(texture_instance_name.c_str());
+        if (texture_instance != nullptr &&
+            (texture_name != texture_instance->get_texture_name() ||
+             texture_instance->get_parameters() != texture_instance_params))
+        {
+            texture_instance_name = make_unique_name(base_group.texture_instances(), texture_instance_name);
+            texture_instance = nullptr;
+        }
+
+        if (texture_instance == nullptr)
+        {
+            base_group.texture_instances().insert(
+                asr::TextureInstanceFactory::create(
+                    texture_instance_name.c_str(),
+                    texture_instance_params,
+                    texture_name.c_str()));
+        }
+
+        return texture_instance_name;
+    }
+
+    // Linear RGBA pixels of a bitmap, in scanline order from the top row.
+    struct BitmapPixels
+    {
+        size_t                              m_width;
+        size_t                              m_height;
+        bool                                m_has_alpha;
+        std::vector<BMM_Color_fl>           m_pixels;
+    };
+
+    // Read the pixels of the file of `bitmap_tex` with appleseed's image readers, so that 3ds Max doesn't keep
+    // a copy of the bitmap in memory. The bitmap is only loaded through 3ds Max if the file can't be read.
+    bool read_bitmap_pixels(
+        BitmapTex*          bitmap_tex,
+        const TimeValue     time,
+        BitmapPixels&       result)
+    {
+        const std::string filepath = wide_to_utf8(bitmap_tex->GetMap().GetFullFilePath());
+
+        if (!filepath.empty())
+        {
+            try
+            {
+                asf::GenericImageFileReader reader;
+                asf::ImageAttributes attributes;
+                std::unique_ptr<asf::Image> image(reader.read(filepath.c_str(), &attributes));
+
+                const asf::CanvasProperties& props = image->properties();
+                const size_t channel_count = props.m_channel_count;
+                const bool is_linear = is_linear_texture(bitmap_tex);
+
+                result.m_width = props.m_canvas_width;
+                result.m_height = props.m_canvas_height;
+                result.m_has_alpha = channel_count == 2 || channel_count >= 4;
+                result.m_pixels.resize(result.m_width * result.m_height);
+
+                for (size_t y = 0; y < result.m_height; ++y)
+                {
+                    for (size_t x = 0; x < result.m_width; ++x)
+                    {
+                        const asf::Tile& tile = image->tile(x / props.m_tile_width, y / props.m_tile_height);
+                        const size_t tx = x % props.m_tile_width;
+                        const size_t ty = y % props.m_tile_height;
+
+                        asf::Color3f color;
+                        float alpha = 1.0f;
+
+                        if (channel_count < 3)
+                        {
+                            color = asf::Color3f(tile.get_component<float>(tx, ty, 0));
+                            if (channel_count == 2)
+                                alpha = tile.get_component<float>(tx, ty, 1);
+                        }
+                        else
+                        {
+                            for (size_t c = 0; c < 3; ++c)
+                                color[c] = tile.get_component<float>(tx, ty, c);
+                            if (channel_count >= 4)
+                                alpha = tile.get_component<float>(tx, ty, 3);
+                        }
+
+                        if (!is_linear)
+                            color = asf::srgb_to_linear_rgb(color);
+
+                        result.m_pixels[y * result.m_width + x] = BMM_Color_fl(color.r, color.g, color.b, alpha);
+                    }
+                }
+
+                return true;
+            }
+            catch (const std::exception& e)
+            {
+                RENDERER_LOG_DEBUG(
+                    "could not read %s, loading it through 3ds Max instead: %s",
+                    filepath.c_str(),
+                    e.what());
+            }
+        }
+
+        Bitmap* bitmap = bitmap_tex->GetBitmap(time);
+        if (bitmap == nullptr)
+            return false;
+
+        result.m_width = static_cast<size_t>(bitmap->Width());
+        result.m_height = static_cast<size_t>(bitmap->Height());
+        result.m_has_alpha = bitmap->HasAlpha() != FALSE;
+        result.m_pixels.resize(result.m_width * result.m_height);
+
+        if (result.m_width == 0)
+            return true;
+
+        for (size_t y = 0; y < result.m_height; ++y)
+        {
+            bitmap->GetLinearPixels(
+                0,
+                static_cast<int>(y),
+                static_cast<int>(result.m_width),
+                &result.m_pixels[y * result.m_width]);
+        }
+
+        return true;
+    }
+
+    // Opacity values at or above this threshold are opaque in cutout masks.
+    const float CutoutMaskThreshold = 0.5f;
+
+    // Whether alpha maps are thresholded into cutout masks (see CutoutMaskScope).
+    bool g_cutout_alpha_maps = false;
+
+    // Cutout masks built during this session: source file path, modification time and opacity settings -> mask
+    // file path. An empty mask file path denotes a bitmap that could not be thresholded.
+    std::map<std::string, std::string> g_cutout_masks;
+
+    // Return the opacity of a pixel the way 3ds Max derives the mono output of a bitmap map.
+    float get_cutout_opacity(
+        const BMM_Color_fl& c,
+        const bool          has_alpha,
+        const int           alpha_source,
+        const bool          alpha_as_mono)
+    {
+        const float intensity = asf::luminance(asf::Color3f(c.r, c.g, c.b));
+
+        if (!alpha_as_mono)
+            return intensity;
+
+        switch (alpha_source)
+        {
+          case ALPHA_FILE: return has_alpha ? c.a : 1.0f;
+          case ALPHA_RGB: return intensity;
+          default: return 1.0f;
+        }
+    }
+
+    bool write_cutout_mask(
+        BitmapTex*          bitmap_tex,
+        const TimeValue     time,
+        const std::string&  mask_filepath)
+    {
+        BitmapPixels bitmap;
+        if (!read_bitmap_pixels(bitmap_tex, time, bitmap))
+            return false;
+
+        const size_t width = bitmap.m_width;
+        const size_t height = bitmap.m_height;
+        if (width == 0 || height == 0)
+            return false;
+
+        const int alpha_source = bitmap_tex->GetAlphaSource();
+        const bool alpha_as_mono = bitmap_tex->GetAlphaAsMono(TRUE) != FALSE;
+
+        asf::Image mask(width, height, 32, 32, 1, asf::PixelFormatUInt8);
+        const asf::CanvasProperties& props = mask.properties();
+
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                const float opacity =
+                    get_cutout_opacity(bitmap.m_pixels[y * width + x], bitmap.m_has_alpha, alpha_source, alpha_as_mono);
+                const asf::uint8 value = opacity >= CutoutMaskThreshold ? 255 : 0;
+
+                mask.tile(x / props.m_tile_width, y / props.m_tile_height).set_component(
+                    x % props.m_tile_width,
+                    y % props.m_tile_height,
+                    0,
+                    value);
+            }
+        }
+
+        try
+        {
+            asf::GenericImageFileWriter writer;
+            writer.write(mask_filepath.c_str(), mask);
+        }
+        catch (const std::exception& e)
+        {
+            RENDERER_LOG_ERROR("failed to write cutout mask %s: %s", mask_filepath.c_str(), e.what());
+            return false;
+        }
+
+        return true;
+    }
+
+    // Return true if `bitmap_tex` maps its bitmap exactly once onto the UV square, in which case a disk texture
+    // looked up with the mesh's UVs matches the result of sampling the map through 3ds Max.
+    bool has_identity_uv_mapping(BitmapTex* bitmap_tex, const TimeValue time)
+    {
+        StdUVGen* uvgen = bitmap_tex->GetUVGen();
+        if (uvgen == nullptr)
+            return true;
+
+        return
+            uvgen->GetUScl(time) == 1.0f &&
+            uvgen->GetVScl(time) == 1.0f &&
+            uvgen->GetUOffs(time) == 0.0f &&
+            uvgen->GetVOffs(time) == 0.0f &&
+            uvgen->GetUAng(time) == 0.0f &&
+            uvgen->GetVAng(time) == 0.0f &&
+            uvgen->GetWAng(time) == 0.0f;
+    }
+
+    // Return the path of a single-channel mask holding the thresholded opacity of `bitmap_tex`, or an empty
+    // string if no mask could be built. Masks are written to the 3ds Max temporary directory and reused for
+    // as long as the source file and the opacity settings of the map are unchanged, also across sessions.
+    std::string get_cutout_mask(BitmapTex* bitmap_tex, const TimeValue time)
+    {
+        const std::wstring filepath = bitmap_tex->GetMap().GetFullFilePath().data();
+
+        std::string key;
+        if (!make_file_version_key(filepath, key))
+            return std::string();
+
+        key += "|" + asf::to_string(bitmap_tex->GetAlphaSource());
+        key += "|" + asf::to_string(bitmap_tex->GetAlphaAsMono(TRUE) != FALSE ? 1 : 0);
+        key += "|" + asf::to_string(CutoutMaskThreshold);
+
+        const auto it = g_cutout_masks.find(key);
+        if (it != g_cutout_masks.end())
+            return it->second;
+
+        std::string mask_filepath = wide_to_utf8(GetCOREInterface()->GetDir(APP_TEMP_DIR));
+        mask_filepath += "\\appleseed-cutout-";
+        mask_filepath += asf::to_string(asf::siphash24(key.c_str(), key.size()));
+        mask_filepath += ".png";
+
+        if (PathFileExists(utf8_to_wide(mask_filepath).c_str()) != TRUE)
+        {
+            if (write_cutout_mask(bitmap_tex, time, mask_filepath))
+            {
+                RENDERER_LOG_DEBUG(
+                    "wrote cutout mask %s for %s.",
+                    mask_filepath.c_str(),
+                    wide_to_utf8(filepath).c_str());
+            }
+            else mask_filepath.clear();
+        }
+
+        g_cutout_masks.insert(std::make_pair(key, mask_filepath));
+
+        return mask_filepath;
+    }
+
+    // Whether bump maps are baked into normal maps (see BumpMapBakingScope).
+    bool g_bake_bump_maps = false;
+
+    // Height, in UV units, of a unit value of a baked height field: a height of 1 rises over 1/256 of the
+    // texture, so that the slopes of the baked normals don't depend on the resolution of the bitmap.
+    const float BakedBumpHeightScale = 1.0f / 256.0f;
+
+    // Normal maps baked during this session: source file path and modification time -> normal map file path.
+    // An empty normal map file path denotes a bitmap that could not be baked.
+    std::map<std::string, std::string> g_bump_normal_maps;
+
+    bool write_bump_normal_map(
+        BitmapTex*          bitmap_tex,
+        const TimeValue     time,
+        const std::string&  normal_map_filepath)
+    {
+        BitmapPixels bitmap;
+        if (!read_bitmap_pixels(bitmap_tex, time, bitmap))
+            return false;
+
+        const size_t width = bitmap.m_width;
+        const size_t height = bitmap.m_height;
+        if (width < 2 || height < 2)
+            return false;
+
+        // Height field, using the first channel like the unbaked bump map lookups do.
+        std::vector<float> heights(width * height);
+
+        for (size_t i = 0; i < width * height; ++i)
+            heights[i] = bitmap.m_pixels[i].r;
+
+        asf::Image normal_map(width, height, 32, 32, 3, asf::PixelFormatUInt8);
+        const asf::CanvasProperties& props = normal_map.properties();
+
+        const float du_scale = static_cast<float>(width) * BakedBumpHeightScale;
+        const float dv_scale = static_cast<float>(height) * BakedBumpHeightScale;
+
+        for (size_t y = 0; y < height; ++y)
+        {
+            // Bitmap rows go down while V goes up; the texture wraps around.
+            const size_t y_up = (y + height - 1) % height;
+            const size_t y_down = (y + 1) % height;
+
+            for (size_t x = 0; x < width; ++x)
+            {
+                const size_t x_left = (x + width - 1) % width;
+                const size_t x_right = (x + 1) % width;
+
+                // Central differences, converted from texels to UV units.
+                const float du = 0.5f * du_scale * (heights[y * width + x_right] - heights[y * width + x_left]);
+                const float dv = 0.5f * dv_scale * (heights[y_up * width + x] - heights[y_down * width + x]);
+
+                const asf::Vector3f n = asf::normalize(asf::Vector3f(-du, -dv, 1.0f));
+
+                asf::Tile& tile = normal_map.tile(x / props.m_tile_width, y / props.m_tile_height);
+
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    tile.set_component(
+                        x % props.m_tile_width,
+                        y % props.m_tile_height,
+                        c,
+                        static_cast<asf::uint8>(asf::clamp(0.5f * n[c] + 0.5f, 0.0f, 1.0f) * 255.0f + 0.5f));
+                }
+            }
+        }
+
+        try
+        {
+            asf::GenericImageFileWriter writer;
+            writer.write(normal_map_filepath.c_str(), normal_map);
+        }
+        catch (const std::exception& e)
+        {
+            RENDERER_LOG_ERROR("failed to write baked normal map %s: %s", normal_map_filepath.c_str(), e.what());
+            return false;
+        }
+
+        return true;
+    }
+}
+
+SharedTextureScope::SharedTextureScope(asr::BaseGroup& base_group)
+{
+    DbgAssert(g_shared_textures == nullptr);
+
+    g_shared_textures = new SharedTextures();
+    g_shared_textures->m_base_group = &base_group;
+    g_shared_textures->m_footprint = 0.0f;
+    g_shared_textures->m_time = 0;
+    g_shared_textures->m_saved_bytes = 0;
+}
+
+SharedTextureScope::~SharedTextureScope()
+{
+    const size_t variant_count = g_shared_textures->m_bound_variants.size();
+    if (variant_count > 0)
+    {
+        RENDERER_LOG_INFO(
+            "bound %s reduced texture variant%s, saving %s of texture data.",
+            asf::pretty_uint(variant_count).c_str(),
+            variant_count > 1 ? "s" : "",
+            asf::pretty_size(g_shared_textures->m_saved_bytes).c_str());
+    }
+
+    delete g_shared_textures;
+    g_shared_textures = nullptr;
+}
+
+TextureFootprintScope::TextureFootprintScope(const float footprint, const TimeValue time)
+{
+    if (g_shared_textures != nullptr)
+    {
+        g_shared_textures->m_footprint = footprint;
+        g_shared_textures->m_time = time;
+    }
+}
+
+TextureFootprintScope::~TextureFootprintScope()
+{
+    if (g_shared_textures != nullptr)
+        g_shared_textures->m_footprint = 0.0f;
+}
+
+BumpMapBakingScope::BumpMapBakingScope(const bool enabled)
+{
+    DbgAssert(!g_bake_bump_maps);
+
+    g_bake_bump_maps = enabled;
+}
+
+BumpMapBakingScope::~BumpMapBakingScope()
+{
+    g_bake_bump_maps = false;
+}
+
+CutoutMaskScope::CutoutMaskScope(const bool enabled)
+{
+    DbgAssert(!g_cutout_alpha_maps);
+
+    g_cutout_alpha_maps = enabled;
+}
+
+CutoutMaskScope::~CutoutMaskScope()
+{
+    g_cutout_alpha_maps = false;
+}
+
+std::string get_bump_normal_map(BitmapTex* bitmap_tex, const TimeValue time)
+{
+    if (!g_bake_bump_maps)
+        return std::string();
+
+    const std::wstring filepath = bitmap_tex->GetMap().GetFullFilePath().data();
+
+    std::string key;
+    if (!make_file_version_key(filepath, key))
+        return std::string();
+
+    key += "|r|" + asf::to_string(BakedBumpHeightScale);
+
+    const auto it = g_bump_normal_maps.find(key);
+    if (it != g_bump_normal_maps.end())
+        return it->second;
+
+    std::string normal_map_filepath = wide_to_utf8(GetCOREInterface()->GetDir(APP_TEMP_DIR));
+    normal_map_filepath += "\\appleseed-bump-normals-";
+    normal_map_filepath += asf::to_string(asf::siphash24(key.c_str(), key.size()));
+    normal_map_filepath += ".png";
+
+    if (PathFileExists(utf8_to_wide(normal_map_filepath).c_str()) != TRUE)
+    {
+        if (write_bump_normal_map(bitmap_tex, time, normal_map_filepath))
+        {
+            RENDERER_LOG_DEBUG(
+                "baked bump map %s into normal map %s.",
+                wide_to_utf8(filepath).c_str(),
+                normal_map_filepath.c_str());
+        }
+        else normal_map_filepath.clear();
+    }
+
+    g_bump_normal_maps.insert(std::make_pair(key, normal_map_filepath));
+
+    return normal_map_filepath;
+}
+
 std::string insert_bitmap_texture_and_instance(
     asr::BaseGroup& base_group,
     BitmapTex*      bitmap_tex,
@@ -340,8 +1078,7 @@ std::string insert_bitmap_texture_and_instance(
     asr::ParamArray texture_instance_params)
 {
     // todo: it can happen that `filepath` is empty here; report an error.
-    const std::string filepath = wide_to_utf8(bitmap_tex->GetMap().GetFullFilePath());
-    texture_params.insert("filename", filepath);
+    std::string filepath = wide_to_utf8(bitmap_tex->GetMap().GetFullFilePath());
 
     if (!texture_params.strings().exist("color_space"))
     {
@@ -350,27 +1087,71 @@ std::string insert_bitmap_texture_and_instance(
         else texture_params.insert("color_space", "srgb");
     }
 
-    const std::string texture_name = wide_to_utf8(bitmap_tex->GetName());
-    if (base_group.textures().get_by_name(texture_name.c_str()) == nullptr)
+    if (g_shared_textures != nullptr && g_shared_textures->m_footprint > 0.0f && !filepath.empty())
     {
-        base_group.textures().insert(
-            asr::DiskTexture2dFactory().create(
-                texture_name.c_str(),
-                texture_params,
-                asf::SearchPaths()));
+        // Tiling repeats the texture across the surface, and filtering needs about twice as many texels as pixels.
+        float tiling = 1.0f;
+        StdUVGen* uvgen = bitmap_tex->GetUVGen();
+        if (uvgen != nullptr)
+        {
+            tiling = std::max(
+                std::abs(uvgen->GetUScl(g_shared_textures->m_time)),
+                std::abs(uvgen->GetVScl(g_shared_textures->m_time)));
+        }
+
+        const float required_size = 2.0f * g_shared_textures->m_footprint * std::max(tiling, 1.0f);
+        filepath = select_texture_variant(filepath, required_size, *g_shared_textures);
     }
 
-    const std::string texture_instance_name = texture_name + "_inst";
-    if (base_group.texture_instances().get_by_name(texture_instance_name.c_str()) == nullptr)
+    texture_params.insert("filename", filepath);
+
+    return
+        insert_disk_texture_and_instance(
+            base_group,
+            wide_to_utf8(bitmap_tex->GetName()),
+            texture_params,
+            texture_instance_params);
+}
+
+std::string insert_cutout_texture_and_instance(
+    asr::BaseGroup& base_group,
+    Texmap*         texmap,
+    const bool      use_max_procedural_maps,
+    const TimeValue time)
+{
+    // Bitmaps are otherwise sampled through 3ds Max when procedural maps are enabled,
+    // so only substitute a mask when that would not change the mapping.
+    if (g_cutout_alpha_maps &&
+        is_file_bitmap_texture(texmap) &&
+        (!use_max_procedural_maps || has_identity_uv_mapping(static_cast<BitmapTex*>(texmap), time)))
     {
-        base_group.texture_instances().insert(
-            asr::TextureInstanceFactory::create(
-                texture_instance_name.c_str(),
-                texture_instance_params,
-                texture_name.c_str()));
+        BitmapTex* bitmap_tex = static_cast<BitmapTex*>(texmap);
+        const std::string mask_filepath = get_cutout_mask(bitmap_tex, time);
+
+        if (!mask_filepath.empty())
+        {
+            return
+                insert_disk_texture_and_instance(
+                    base_group,
+                    wide_to_utf8(bitmap_tex->GetName()) + "_cutout",
+                    asr::ParamArray()
+                        .insert("filename", mask_filepath)
+                        .insert("color_space", "linear_rgb"),
+                    asr::ParamArray()
+                        .insert("alpha_mode", "luminance")
+                        .insert("filtering_mode", "nearest"));
+        }
     }
 
-    return texture_instance_name;
+    return
+        insert_texture_and_instance(
+            base_group,
+            texmap,
+            use_max_procedural_maps,
+            time,
+            asr::ParamArray(),
+            asr::ParamArray()
+                .insert("alpha_mode", "detect"));
 }
 
 namespace
@@ -379,8 +1160,8 @@ namespace
       : public ShadeContext
     {
       public:
-        MaxShadeContext(const asr::SourceInputs& source_inputs, const TimeValue time)
-            : m_cur_time(time)
+        MaxShadeContext()
+            : m_cur_time(0)
         {
             doMaps = TRUE;
             filterMaps = FALSE;
@@ -389,7 +1170,11 @@ namespace
             ambientLight.Black();
             xshadeID = 0;
             // todo: initialize `out`?
+        }
 
+        void set_inputs(const asr::SourceInputs& source_inputs, const TimeValue time)
+        {
+            m_cur_time = time;
             m_uv.x = source_inputs.m_uv_x;
             m_uv.y = source_inputs.m_uv_y;
         }
@@ -555,14 +1340,165 @@ namespace
         Point3      m_view;             // unit vector from light to point, in light space
     };
 
+    //
+    // Per-thread state for evaluating 3ds Max maps: a shade context that is reused from one
+    // evaluation to the next, and a direct-mapped cache of results keyed on the source,
+    // the time and the quantized UV coordinates.
+    //
+
+    struct MaxMapThreadCache
+    {
+        static const size_t EntryCount = 4096;      // must be a power of two
+
+        struct Entry
+        {
+            asf::uint64     m_source_id;            // 0 for an empty entry
+            TimeValue       m_time;
+            asf::int64      m_u;
+            asf::int64      m_v;
+            bool            m_mono;
+            AColor          m_value;
+
+            Entry()
+              : m_source_id(0)
+              , m_time(0)
+              , m_u(0)
+              , m_v(0)
+              , m_mono(false)
+            {
+            }
+        };
+
+        MaxShadeContext     m_shade_context;
+        std::vector<Entry>  m_entries;
+        size_t              m_stripe;               // index of this thread's statistics counters
+
+        explicit MaxMapThreadCache(const size_t stripe)
+          : m_entries(EntryCount)
+          , m_stripe(stripe)
+        {
+        }
+    };
+
+    // Caches are deleted when their thread exits.
+    boost::thread_specific_ptr<MaxMapThreadCache> g_max_map_thread_cache;
+    std::atomic<size_t> g_max_map_thread_count(0);
+
+    MaxMapThreadCache& get_max_map_thread_cache()
+    {
+        MaxMapThreadCache* cache = g_max_map_thread_cache.get();
+
+        if (cache == nullptr)
+        {
+            cache = new MaxMapThreadCache(g_max_map_thread_count++);
+            g_max_map_thread_cache.reset(cache);
+        }
+
+        return *cache;
+    }
+
+    std::atomic<asf::uint64> g_max_map_source_id(0);
+
+    //
+    // Statistics of the evaluations of a 3ds Max map during a frame, shared by all sources of the map.
+    //
+
+    struct MaxMapStatistics
+    {
+        // Number of counters; threads are spread over them to avoid sharing cache lines.
+        static const size_t StripeCount = 16;
+
+        struct __declspec(align(64)) Counters
+        {
+            std::atomic<asf::uint64>    m_lookups;
+            std::atomic<asf::uint64>    m_hits;
+            std::atomic<asf::uint64>    m_max_calls;
+            std::atomic<asf::uint64>    m_contended_calls;
+            std::atomic<asf::uint64>    m_max_nanoseconds;
+        };
+
+        std::chrono::steady_clock::time_point   m_start_time;
+        std::atomic<size_t>                     m_in_flight;
+        std::atomic<size_t>                     m_peak_in_flight;
+        Counters                                m_counters[StripeCount];
+
+        MaxMapStatistics()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            m_start_time = std::chrono::steady_clock::now();
+            m_in_flight = 0;
+            m_peak_in_flight = 0;
+
+            for (size_t i = 0; i < StripeCount; ++i)
+            {
+                m_counters[i].m_lookups = 0;
+                m_counters[i].m_hits = 0;
+                m_counters[i].m_max_calls = 0;
+                m_counters[i].m_contended_calls = 0;
+                m_counters[i].m_max_nanoseconds = 0;
+            }
+        }
+
+        void print(Texmap* texmap) const
+        {
+            asf::uint64 lookups = 0, hits = 0, max_calls = 0, contended_calls = 0, max_nanoseconds = 0;
+
+            for (size_t i = 0; i < StripeCount; ++i)
+            {
+                lookups += m_counters[i].m_lookups;
+                hits += m_counters[i].m_hits;
+                max_calls += m_counters[i].m_max_calls;
+                contended_calls += m_counters[i].m_contended_calls;
+                max_nanoseconds += m_counters[i].m_max_nanoseconds;
+            }
+
+            if (lookups == 0)
+                return;
+
+            const double elapsed =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+
+            RENDERER_LOG_INFO(
+                "3ds Max map \"%s\": %s lookup%s (%s/s), %s cache hit%s (%s).",
+                wide_to_utf8(texmap->GetName()).c_str(),
+                asf::pretty_uint(lookups).c_str(),
+                lookups > 1 ? "s" : "",
+                asf::pretty_scalar(elapsed > 0.0 ? lookups / elapsed : 0.0, 0).c_str(),
+                asf::pretty_uint(hits).c_str(),
+                hits > 1 ? "s" : "",
+                asf::pretty_percent(hits, lookups).c_str());
+
+            if (max_calls > 0)
+            {
+                RENDERER_LOG_INFO(
+                    "3ds Max map \"%s\": %s call%s into 3ds Max, %s contended (up to %s concurrent), %s per call on average.",
+                    wide_to_utf8(texmap->GetName()).c_str(),
+                    asf::pretty_uint(max_calls).c_str(),
+                    max_calls > 1 ? "s" : "",
+                    asf::pretty_percent(contended_calls, max_calls).c_str(),
+                    asf::pretty_uint(static_cast<asf::uint64>(m_peak_in_flight)).c_str(),
+                    asf::pretty_time(max_nanoseconds * 1.0e-9 / max_calls, 1).c_str());
+            }
+        }
+    };
+
     class MaxProceduralTextureSource
       : public asr::Source
     {
       public:
-        MaxProceduralTextureSource(Texmap* texmap, const TimeValue time)
+        MaxProceduralTextureSource(
+            Texmap*                     texmap,
+            const TimeValue             time,
+            MaxMapStatistics&           statistics)
           : asr::Source(false)
           , m_texmap(texmap)
           , m_time(time)
+          , m_id(++g_max_map_source_id)
+          , m_statistics(statistics)
         {
         }
 
@@ -575,11 +1511,12 @@ namespace
         {
             Hints hints;
 
-            if (is_bitmap_texture(m_texmap))
+            int width, height;
+            if (m_texmap->ClassID() == Class_ID(BMTEX_CLASS_ID, 0) &&
+                get_bitmap_texture_size(static_cast<BitmapTex*>(m_texmap), width, height))
             {
-                auto bitmap = static_cast<BitmapTex*>(m_texmap)->GetBitmap(0);
-                hints.m_width = static_cast<size_t>(bitmap->Width());
-                hints.m_height = static_cast<size_t>(bitmap->Height());
+                hints.m_width = static_cast<size_t>(width);
+                hints.m_height = static_cast<size_t>(height);
             }
             else
             {
@@ -644,21 +1581,92 @@ namespace
         }
 
       private:
-        Texmap*         m_texmap;
-        const TimeValue m_time;
+        // UV coordinates are quantized to this many steps per unit for cache lookups.
+        static const int UVQuantization = 1 << 16;
 
-        float evaluate_float(const asr::SourceInputs& source_inputs) const
+        Texmap*                                             m_texmap;
+        const TimeValue                                     m_time;
+        const asf::uint64                                   m_id;
+        MaxMapStatistics&                                   m_statistics;
+
+        AColor evaluate_texmap(const asr::SourceInputs& source_inputs, const bool mono) const
         {
-            MaxShadeContext maxsc(source_inputs, m_time);
+            MaxMapThreadCache& cache = get_max_map_thread_cache();
+            MaxMapStatistics::Counters& counters =
+                m_statistics.m_counters[cache.m_stripe % MaxMapStatistics::StripeCount];
+
+            counters.m_lookups.fetch_add(1, std::memory_order_relaxed);
+
+            const asf::int64 u = static_cast<asf::int64>(std::floor(source_inputs.m_uv_x * UVQuantization));
+            const asf::int64 v = static_cast<asf::int64>(std::floor(source_inputs.m_uv_y * UVQuantization));
+
+            asf::uint64 h = m_id * 0x9E3779B97F4A7C15ull;
+            h ^= static_cast<asf::uint64>(u) * 0xC2B2AE3D27D4EB4Full;
+            h ^= static_cast<asf::uint64>(v) * 0x165667B19E3779F9ull;
+            h ^= static_cast<asf::uint64>(m_time) + (mono ? 1 : 0);
+            h ^= h >> 29;
+
+            MaxMapThreadCache::Entry& entry = cache.m_entries[h & (MaxMapThreadCache::EntryCount - 1)];
+
+            if (entry.m_source_id == m_id &&
+                entry.m_time == m_time &&
+                entry.m_u == u &&
+                entry.m_v == v &&
+                entry.m_mono == mono)
+            {
+                counters.m_hits.fetch_add(1, std::memory_order_relaxed);
+                return entry.m_value;
+            }
+
+            // Other threads currently inside this map's evaluation.
+            const size_t others = m_statistics.m_in_flight.fetch_add(1);
+            if (others > 0)
+            {
+                counters.m_contended_calls.fetch_add(1, std::memory_order_relaxed);
+
+                size_t peak = m_statistics.m_peak_in_flight.load(std::memory_order_relaxed);
+                while (others + 1 > peak && !m_statistics.m_peak_in_flight.compare_exchange_weak(peak, others + 1)) {}
+            }
+
+            const auto call_start = std::chrono::steady_clock::now();
 
-            return m_texmap->EvalMono(maxsc);
+            cache.m_shade_context.set_inputs(source_inputs, m_time);
+
+            AColor value;
+            if (mono)
+            {
+                const float f = m_texmap->EvalMono(cache.m_shade_context);
+                value = AColor(f, f, f, f);
+            }
+            else value = m_texmap->EvalColor(cache.m_shade_context);
+
+            const auto call_time = std::chrono::steady_clock::now() - call_start;
+
+            --m_statistics.m_in_flight;
+
+            counters.m_max_calls.fetch_add(1, std::memory_order_relaxed);
+            counters.m_max_nanoseconds.fetch_add(
+                static_cast<asf::uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(call_time).count()),
+                std::memory_order_relaxed);
+
+            entry.m_source_id = m_id;
+            entry.m_time = m_time;
+            entry.m_u = u;
+            entry.m_v = v;
+            entry.m_mono = mono;
+            entry.m_value = value;
+
+            return value;
+        }
+
+        float evaluate_float(const asr::SourceInputs& source_inputs) const
+        {
+            return evaluate_texmap(source_inputs, true).r;
         }
 
         void evaluate_color(const asr::SourceInputs& source_inputs, float& r, float& g, float& b) const
         {
-            MaxShadeContext maxsc(source_inputs, m_time);
-            
-            const AColor tex_color = m_texmap->EvalColor(maxsc);
+            const AColor tex_color = evaluate_texmap(source_inputs, false);
 
             r = tex_color.r;
             g = tex_color.g;
@@ -667,9 +1675,7 @@ namespace
 
         void evaluate_color(const asr::SourceInputs& source_inputs, float& r, float& g, float& b, asr::Alpha& alpha) const
         {
-            MaxShadeContext maxsc(source_inputs, m_time);
-            
-            const AColor tex_color = m_texmap->EvalColor(maxsc);
+            const AColor tex_color = evaluate_texmap(source_inputs, false);
 
             r = tex_color.r;
             g = tex_color.g;
@@ -720,7 +1726,31 @@ namespace
             const asf::UniqueID         assembly_uid,
             const asr::TextureInstance& texture_instance) override
         {
-            return new MaxProceduralTextureSource(m_texmap, m_time);
+            return new MaxProceduralTextureSource(m_texmap, m_time, m_statistics);
+        }
+
+        bool on_frame_begin(
+            const asr::Project&         project,
+            const asr::BaseGroup*       parent,
+            asr::OnFrameBeginRecorder&  recorder,
+            asf::IAbortSwitch*          abort_switch) override
+        {
+            if (!asr::Texture::on_frame_begin(project, parent, recorder, abort_switch))
+                return false;
+
+            // Only count the lookups made while rendering this frame.
+            m_statistics.clear();
+
+            return true;
+        }
+
+        void on_frame_end(
+            const asr::Project&         project,
+            const asr::BaseGroup*       parent) override
+        {
+            m_statistics.print(m_texmap);
+
+            asr::Texture::on_frame_end(project, parent);
         }
 
         asf::Tile* load_tile(
@@ -741,6 +1771,7 @@ namespace
         asf::CanvasProperties   m_properties;
         Texmap*                 m_texmap;
         TimeValue               m_time;
+        MaxMapStatistics        m_statistics;
     };
 
     void load_map_files_recursively(MtlBase* mat_base, TimeValue time)
@@ -33,6 +33,7 @@
 #include "renderer/api/utility.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/image/color.h"
 #include "foundation/image/image.h"
 #include "foundation/math/matrix.h"
@@ -137,8 +138,29 @@ void update_map_buttons(IParamMap2* param_map);
 // Bitmap functions.
 //
 
+// Header information of a bitmap file.
+struct BitmapFileInfo
+{
+    int     m_width;
+    int     m_height;
+    int     m_channel_count;
+    int     m_bits_per_channel;
+};
+
+// Read the dimensions and pixel format of a bitmap file from its header, without loading it.
+// Results are cached per file path and modification time. Return false if the file can't be read.
+bool probe_bitmap_file(const std::wstring& filepath, BitmapFileInfo& info);
+
+// Return the dimensions of the bitmap of a Bitmap map. The files of file-backed bitmaps are probed
+// instead of being loaded by 3ds Max. Return false if there is no bitmap.
+bool get_bitmap_texture_size(BitmapTex* bitmap_tex, int& width, int& height);
+
+// Return true if `map` is a Bitmap map with a bitmap. File-backed bitmaps aren't loaded by 3ds Max.
 bool is_bitmap_texture(Texmap* map);
 
+// Return true if `map` is a Bitmap map whose file exists on disk, whether or not 3ds Max loaded it.
+bool is_file_bitmap_texture(Texmap* map);
+
 bool is_osl_texture(Texmap* map);
 
 bool is_supported_procedural_texture(Texmap* map, const bool use_max_procedural_maps);
@@ -189,6 +211,65 @@ std::string insert_procedural_texture_and_instance(
     renderer::ParamArray    texture_params = renderer::ParamArray(),
     renderer::ParamArray    texture_instance_params = renderer::ParamArray());
 
+// Insert a texture and texture instance suitable for the alpha map of a material. While a CutoutMaskScope is
+// enabled, bitmap textures are thresholded into cached single-channel masks that are looked up without filtering;
+// otherwise, and for other texture maps, the map is inserted as is and its alpha channel is detected.
+std::string insert_cutout_texture_and_instance(
+    renderer::BaseGroup&    base_group,
+    Texmap*                 texmap,
+    const bool              use_max_procedural_maps,
+    const TimeValue         time);
+
+// While an instance of this class is alive, the disk textures created by insert_bitmap_texture_and_instance()
+// are inserted into `base_group` (typically the scene) instead of the base group passed to the function, with
+// a single texture per resolved file path and color space. Texture instances stay in the requesting base group.
+// Only a single instance may be alive at a time, and textures must be inserted from the main thread.
+class SharedTextureScope
+  : public foundation::NonCopyable
+{
+  public:
+    explicit SharedTextureScope(renderer::BaseGroup& base_group);
+    ~SharedTextureScope();
+};
+
+// Set the largest size, in pixels, that surfaces textured by bitmaps inserted while an instance of this
+// class is alive can have on screen. When a SharedTextureScope is alive and the footprint is known (non-zero),
+// insert_bitmap_texture_and_instance() binds the smallest pre-generated variant of a texture that still
+// provides enough resolution. Variants sit next to the original file and are named <name>_<size><ext>,
+// where <size> is their largest dimension (256, 512, ..., 8192), e.g. bark_1024.exr for bark.exr.
+class TextureFootprintScope
+  : public foundation::NonCopyable
+{
+  public:
+    TextureFootprintScope(const float footprint, const TimeValue time);
+    ~TextureFootprintScope();
+};
+
+
+// While an instance of this class is alive and `enabled` is true, get_bump_normal_map() bakes bitmaps
+// used as bump maps into tangent-space normal maps, so that bump shading takes a single texture lookup.
+class BumpMapBakingScope
+  : public foundation::NonCopyable
+{
+  public:
+    explicit BumpMapBakingScope(const bool enabled);
+    ~BumpMapBakingScope();
+};
+
+// While an instance of this class is alive and `enabled` is true, insert_cutout_texture_and_instance()
+// thresholds bitmap alpha maps into cutout masks.
+class CutoutMaskScope
+  : public foundation::NonCopyable
+{
+  public:
+    explicit CutoutMaskScope(const bool enabled);
+    ~CutoutMaskScope();
+};
+
+// Return the path of the normal map baked from the height field of `bitmap_tex`, or an empty string if baking
+// is disabled or failed. Normal maps are written to the 3ds Max temporary directory and reused for as long as
+// the source file is unchanged, also across sessions.
+std::string get_bump_normal_map(BitmapTex* bitmap_tex, const TimeValue time);
 
 //
 // Plugcfg ini file access functions.